@@ -0,0 +1,53 @@
+/* This file is part of the code presented in the paper
+
+	"An Exact Solver for Submodular Knapsack Problems"
+
+by Sabine Münch and Stephen Raach
+==============================================================================*/
+
+#include "Arena.h"
+#include <algorithm>
+#include <cstdint>
+#include <new>
+
+Arena::~Arena() {
+    for (Block& block : blocks) {
+        ::operator delete(block.data);
+    }
+}
+
+void* Arena::do_allocate(size_t n, size_t alignment) {
+    allocations++;
+    bytes += n;
+    for (;;) {
+        if (current < blocks.size()) {
+            Block& block = blocks[current];
+            uintptr_t first = reinterpret_cast<uintptr_t>(block.data) + offset;
+            size_t start = ((first + alignment - 1) & ~(uintptr_t)(alignment - 1)) - reinterpret_cast<uintptr_t>(block.data);
+            if (start + n <= block.size) { // request fits into the current block
+                live += start + n - offset;
+                peak = std::max(peak, live);
+                offset = start + n;
+                return block.data + start;
+            }
+            current++; // continue in the next block, the rest of the current block stays unused
+            offset = 0;
+            if (current < blocks.size() && blocks[current].size >= n + alignment) {
+                continue;
+            }
+            if (current < blocks.size()) { // next block is too small, it is not in use and can be replaced
+                ::operator delete(blocks[current].data);
+                blocks.erase(blocks.begin() + current);
+            }
+        }
+        size_t size = std::max(block_size, n + alignment);
+        blocks.insert(blocks.begin() + current, Block{static_cast<char*>(::operator new(size)), size});
+        offset = 0;
+    }
+}
+
+void Arena::release(const Marker& marker) {
+    current = marker.block;
+    offset = marker.offset;
+    live = marker.live;
+}
@@ -0,0 +1,70 @@
+/* This file is part of the code presented in the paper
+
+	"An Exact Solver for Submodular Knapsack Problems"
+
+by Sabine Münch and Stephen Raach
+==============================================================================*/
+
+#ifndef Arena_H
+#define Arena_H
+
+#include <memory_resource>
+#include <vector>
+#include <cstddef>
+
+// bump allocator for the buffers of search nodes (candidate sets, gains, greedy orders)
+// memory is handed out in order and never freed individually, release() rewinds the arena to a marker
+// every search node takes a marker when it is entered and releases it on backtrack
+class Arena : public std::pmr::memory_resource {
+public:
+    struct Marker {
+        size_t block;
+        size_t offset;
+        size_t live;
+    };
+
+    explicit Arena(size_t block_size = 1 << 20) : block_size(block_size) {}
+    ~Arena();
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    Marker mark() const { return {current, offset, live}; }
+    void release(const Marker& marker);
+
+    // counters
+    size_t bytes = 0;       // total bytes allocated
+    size_t allocations = 0; // total number of allocations
+    size_t peak = 0;        // maximal number of bytes in use at the same time
+
+private:
+    struct Block {
+        char* data;
+        size_t size;
+    };
+    std::vector<Block> blocks;
+    size_t block_size;
+    size_t current = 0; // block that is currently filled
+    size_t offset = 0;  // first free byte in the current block
+    size_t live = 0;    // bytes in use
+
+    void* do_allocate(size_t n, size_t alignment) override;
+    void do_deallocate(void*, size_t, size_t) override {} // memory is reclaimed by release()
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+};
+
+// takes a marker of the arena and releases it when the scope is left
+class ArenaScope {
+public:
+    explicit ArenaScope(Arena& arena) : arena(arena), marker(arena.mark()) {}
+    ~ArenaScope() { arena.release(marker); }
+
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+
+private:
+    Arena& arena;
+    Arena::Marker marker;
+};
+
+#endif
@@ -0,0 +1,45 @@
+/* This file is part of the code presented in the paper
+
+	"An Exact Solver for Submodular Knapsack Problems"
+
+by Sabine Münch and Stephen Raach
+==============================================================================*/
+
+#include "COVEngine.h"
+#include "Load.h"
+#include "Numeric.h"
+
+COVEngine::COVEngine() : covered(values.size(), 0) {}
+
+void COVEngine::push(int v) {
+    for (int k = first_element[v]; k < first_element[v + 1]; ++k) {
+        covered[elements[k]]++;
+    }
+}
+
+void COVEngine::pop() {
+    int v = path.back();
+    for (int k = first_element[v]; k < first_element[v + 1]; ++k) {
+        covered[elements[k]]--;
+    }
+}
+
+void COVEngine::evaluate(const int* C, size_t n, float* out) const {
+    const int* e = elements.data();
+    const float* value = values.data();
+    const int* cov = covered.data();
+    for (size_t k = 0; k < n; ++k) {
+        if (k + 1 < n) { // elements of the next item are loaded while this item is summed up
+            __builtin_prefetch(e + first_element[C[k + 1]]);
+        }
+        Accumulator sum;
+        for (int i = first_element[C[k]]; i < first_element[C[k] + 1]; ++i) {
+            sum.add(cov[e[i]] == 0 ? value[e[i]] : 0.0f); // only uncovered elements add value
+        }
+        out[k] = sum.value();
+    }
+}
+
+size_t COVEngine::work(size_t n) const {
+    return n * (elements.size() / (first_element.size() - 1) + 1); // average number of elements per item
+}
@@ -0,0 +1,33 @@
+/* This file is part of the code presented in the paper
+
+	"An Exact Solver for Submodular Knapsack Problems"
+
+by Sabine Münch and Stephen Raach
+==============================================================================*/
+
+#ifndef COVEngine_H
+#define COVEngine_H
+
+#include <vector>
+#include <cstddef>
+#include "ObjectiveEngine.h"
+
+// incremental state for the objective COV
+// covered[e] is the number of items in the current set S that cover element e of the ground set
+// the marginal gain of c is the sum of values[e] over the elements of c with covered[e] == 0
+// popping an item decrements the counters of its elements again, so no undo log is needed
+class COVEngine : public ObjectiveEngine {
+public:
+    // state of the empty set, uses the adjacency built by loadData_f1
+    COVEngine();
+
+private:
+    std::vector<int> covered;
+
+    void push(int v) override;
+    void pop() override;
+    void evaluate(const int* C, size_t n, float* out) const override;
+    size_t work(size_t n) const override;
+};
+
+#endif
@@ -0,0 +1,52 @@
+/* This file is part of the code presented in the paper
+
+	"An Exact Solver for Submodular Knapsack Problems"
+
+by Sabine Münch and Stephen Raach
+==============================================================================*/
+
+#include "GainCache.h"
+
+// splitmix64, the keys only need to be distinct and well mixed
+static uint64_t next(uint64_t& state) {
+    uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+void GainCache::resize(size_t entries, size_t items, uint64_t seed) {
+    table.clear();
+    path.clear();
+    prefix.clear();
+    if (entries == 0) {
+        return;
+    }
+    size_t size = 1;
+    while (size < entries) {
+        size *= 2;
+    }
+    table.assign(size, Entry());
+    mask = size - 1;
+    item.resize(items);
+    candidate.resize(items);
+    for (size_t i = 0; i < items; ++i) {
+        item[i] = next(seed);
+        candidate[i] = next(seed);
+    }
+    prefix.push_back(next(seed)); // the empty set has a nonzero hash, so it is not mistaken for an empty slot
+}
+
+uint64_t GainCache::hash(const std::vector<int>& S) {
+    size_t common = 0;
+    while (common < path.size() && common < S.size() && path[common] == S[common]) {
+        common++;
+    }
+    path.resize(common);
+    prefix.resize(common + 1);
+    for (size_t k = common; k < S.size(); ++k) {
+        path.push_back(S[k]);
+        prefix.push_back(prefix.back() ^ item[S[k]]);
+    }
+    return prefix.back();
+}
@@ -0,0 +1,67 @@
+/* This file is part of the code presented in the paper
+
+	"An Exact Solver for Submodular Knapsack Problems"
+
+by Sabine Münch and Stephen Raach
+==============================================================================*/
+
+#ifndef GainCache_H
+#define GainCache_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// bounded cache of the marginal gains and objective values computed on the search path
+// keys are Zobrist hashes: hash(S) is the xor of a random key per item of S, it is updated incrementally when items are pushed or popped
+// the gain f(S+c)-f(S) is stored under hash(S) ^ candidate[c], the value f(S) under hash(S)
+// so f(S+c) = f(S) + gain is known for every child S+c whose gain was evaluated at S without calling f again
+// the table is direct mapped, a new entry replaces the entry in its slot
+class GainCache {
+public:
+    // table of the given number of entries (rounded up to a power of two) for items 0, ..., items-1, 0 entries disable the cache
+    void resize(size_t entries, size_t items, uint64_t seed = 0x9e3779b97f4a7c15ull);
+
+    bool enabled() const { return !table.empty(); }
+
+    // hash of S, the hash of the previous set is reused for the common prefix
+    uint64_t hash(const std::vector<int>& S);
+
+    // hash of S-v for v in S
+    uint64_t without(uint64_t h, int v) const { return h ^ item[v]; }
+
+    // key of the gain of c at the set with hash h
+    uint64_t gainkey(uint64_t h, int c) const { return h ^ candidate[c]; }
+
+    void store(uint64_t key, float value) {
+        Entry& e = table[key & mask];
+        e.key = key;
+        e.value = value;
+    }
+
+    bool find(uint64_t key, float& value) const {
+        const Entry& e = table[key & mask];
+        if (e.key != key) {
+            return false;
+        }
+        value = e.value;
+        return true;
+    }
+
+    // node values taken from the cache instead of f
+    long hits = 0;
+
+private:
+    struct Entry {
+        uint64_t key = 0;
+        float value = 0.0f;
+    };
+    std::vector<Entry> table;
+    uint64_t mask = 0;
+    std::vector<uint64_t> item;      // key of an item in S
+    std::vector<uint64_t> candidate; // key of an item as candidate c
+    std::vector<int> path;           // set of the last hash
+    std::vector<uint64_t> prefix;    // prefix[k] is the hash of the first k items of path, prefix[0] is the hash of the empty set
+};
+
+#endif
@@ -0,0 +1,98 @@
+/* This file is part of the code presented in the paper
+
+	"An Exact Solver for Submodular Knapsack Problems"
+
+by Sabine Münch and Stephen Raach
+==============================================================================*/
+
+#include "GainTable.h"
+#include <algorithm>
+#include <numeric>
+#include <limits>
+#include <thread>
+#include "Numa.h"
+
+// runs task(t) for t = 0,...,count-1 on the given number of threads
+static void parallel(size_t count, unsigned threads, const std::function<void(size_t)>& task) {
+    threads = std::max(1u, std::min<unsigned>(threads, count));
+    if (threads == 1) {
+        for (size_t t = 0; t < count; ++t) {
+            task(t);
+        }
+        return;
+    }
+    std::vector<std::thread> workers;
+    for (unsigned w = 0; w < threads; ++w) {
+        workers.emplace_back([&, w]() {
+            Numa::pin_worker(w);
+            for (size_t t = w; t < count; t += threads) {
+                task(t);
+            }
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+void GainTable::build(const std::function<float(const std::vector<int>&)>& f, const std::function<float(int)>& single, const std::vector<int>& weights, size_t k, unsigned threads) {
+    size_t n = weights.size();
+
+    // singletons
+    singleton.assign(n, 0.0f);
+    parallel(n, threads, [&](size_t i) {
+        singleton[i] = single(i);
+    });
+
+    // top k items according to relative singleton value
+    this->k = std::min(k, n);
+    slot.assign(n, -1);
+    if (this->k == 0) {
+        return;
+    }
+    std::vector<int> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+        return singleton[a] / weights[a] > singleton[b] / weights[b];
+    });
+    for (size_t s = 0; s < this->k; ++s) {
+        slot[order[s]] = s;
+    }
+
+    // pairs f({i,j}) in both orders, each row of the table is one task
+    pair.assign(this->k * this->k, 0.0f);
+    parallel(this->k, threads, [&](size_t s) {
+        int i = order[s];
+        for (size_t t = 0; t < this->k; ++t) {
+            pair[s * this->k + t] = (s == t) ? singleton[i] : f({i, order[t]});
+        }
+    });
+}
+
+bool GainTable::find(const std::vector<int>& S, int c, float& value) const {
+    if (singleton.empty()) { // table not built
+        return false;
+    }
+    if (S.empty()) {
+        value = singleton[c];
+        return true;
+    }
+    if (S.size() == 1 && slot[S[0]] >= 0 && slot[c] >= 0) {
+        value = pair[slot[S[0]] * k + slot[c]];
+        return true;
+    }
+    return false;
+}
+
+float GainTable::upper(const std::vector<int>& S, int c) const {
+    float bound = std::numeric_limits<float>::infinity();
+    if (k == 0 || slot[c] < 0) {
+        return bound;
+    }
+    for (int s : S) {
+        if (slot[s] >= 0) {
+            bound = std::min(bound, pair[slot[s] * k + slot[c]] - singleton[s]);
+        }
+    }
+    return bound;
+}
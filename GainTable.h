@@ -0,0 +1,47 @@
+/* This file is part of the code presented in the paper
+
+	"An Exact Solver for Submodular Knapsack Problems"
+
+by Sabine Münch and Stephen Raach
+==============================================================================*/
+
+#ifndef GainTable_H
+#define GainTable_H
+
+#include <vector>
+#include <functional>
+#include <cstddef>
+
+// read-only table of objective values computed once at startup
+// singleton[i] = f({i}) for all items
+// for the k items with the highest relative singleton value also the pair values f({i,j}) are stored
+// pair values are stored for both orders, so a lookup returns exactly what f(S+c) returns for S = {i}, c = j
+class GainTable {
+public:
+    // evaluates all singletons with single(i) = f({i}) and the pairs of the top k items with f, the evaluations are split over the given number of threads
+    void build(const std::function<float(const std::vector<int>&)>& f, const std::function<float(int)>& single, const std::vector<int>& weights, size_t k, unsigned threads);
+
+    // true once build was called
+    bool built() const { return !singleton.empty(); }
+
+    // objective value f({i})
+    float single(int i) const { return singleton[i]; }
+
+    // Input: set S and item c
+    // Output: true and value = f(S+c) if S+c is a stored singleton or pair
+    bool find(const std::vector<int>& S, int c, float& value) const;
+
+    // upper bound for the marginal gain f(S+c)-f(S) from the pairs of c with the items of S
+    // by submodularity f(S+c)-f(S) <= f({s,c})-f({s}) for every s in S, returns infinity if no pair is stored
+    float upper(const std::vector<int>& S, int c) const;
+
+    size_t pairs() const { return k; }
+
+private:
+    std::vector<float> singleton;
+    std::vector<int> slot; // position of an item in the pair table, -1 if its pairs are not stored
+    std::vector<float> pair; // pair[slot[i] * k + slot[j]] = f({i,j})
+    size_t k = 0;
+};
+
+#endif
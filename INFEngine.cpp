@@ -0,0 +1,107 @@
+/* This file is part of the code presented in the paper
+
+	"An Exact Solver for Submodular Knapsack Problems"
+
+by Sabine Münch and Stephen Raach
+==============================================================================*/
+
+#include "INFEngine.h"
+#include "Load.h"
+#include "Numeric.h"
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+INFEngine::INFEngine() : surv(m, 1.0f) {}
+
+void INFEngine::push(int v) {
+    undo_start.push_back(undo.size());
+    float q = 1 - p[v];
+    for (int k = first_target[v]; k < first_target[v + 1]; ++k) {
+        float& s = surv[targets[k]];
+        undo.push_back(s);
+        s *= q;
+    }
+}
+
+void INFEngine::pop() {
+    int v = path.back();
+    size_t u = undo_start.back();
+    for (int k = first_target[v]; k < first_target[v + 1]; ++k) {
+        surv[targets[k]] = undo[u++];
+    }
+    undo.resize(undo_start.back());
+    undo_start.pop_back();
+}
+
+float INFEngine::kernel(int c) const {
+    const int* t = targets.data();
+    int k = first_target[c];
+    int end = first_target[c + 1];
+    Accumulator sum;
+#ifdef __AVX2__
+    // gather 8 survival values at once
+#if defined(PRECISION_DOUBLE)
+    // the 8 floats are widened and added to 2x4 double lanes
+    __m256d low = _mm256_setzero_pd();
+    __m256d high = _mm256_setzero_pd();
+    for (; k + 8 <= end; k += 8) {
+        __m256i index = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(t + k));
+        __m256 values = _mm256_i32gather_ps(surv.data(), index, 4);
+        low = _mm256_add_pd(low, _mm256_cvtps_pd(_mm256_castps256_ps128(values)));
+        high = _mm256_add_pd(high, _mm256_cvtps_pd(_mm256_extractf128_ps(values, 1)));
+    }
+    double lanes[8];
+    _mm256_storeu_pd(lanes, low);
+    _mm256_storeu_pd(lanes + 4, high);
+    for (double lane : lanes) {
+        sum.add(lane);
+    }
+#else
+    __m256 acc = _mm256_setzero_ps();
+#ifdef PRECISION_KAHAN
+    __m256 carry = _mm256_setzero_ps(); // compensation of every lane
+#endif
+    for (; k + 8 <= end; k += 8) {
+        __m256i index = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(t + k));
+        __m256 values = _mm256_i32gather_ps(surv.data(), index, 4);
+#ifdef PRECISION_KAHAN
+        __m256 y = _mm256_sub_ps(values, carry);
+        __m256 next = _mm256_add_ps(acc, y);
+        carry = _mm256_sub_ps(_mm256_sub_ps(next, acc), y);
+        acc = next;
+#else
+        acc = _mm256_add_ps(acc, values);
+#endif
+    }
+    float lanes[8];
+    _mm256_storeu_ps(lanes, acc);
+    for (float lane : lanes) {
+        sum.add(lane);
+    }
+#ifdef PRECISION_KAHAN
+    _mm256_storeu_ps(lanes, carry);
+    for (float lane : lanes) {
+        sum.add(-lane);
+    }
+#endif
+#endif
+#endif
+    for (; k < end; ++k) {
+        sum.add(surv[t[k]]);
+    }
+    return p[c] * sum.value();
+}
+
+void INFEngine::evaluate(const int* C, size_t n, float* out) const {
+    for (size_t k = 0; k < n; ++k) {
+        if (k + 1 < n) { // targets of the next item are loaded while the gather of this item runs
+            __builtin_prefetch(targets.data() + first_target[C[k + 1]]);
+        }
+        out[k] = kernel(C[k]);
+    }
+}
+
+size_t INFEngine::work(size_t n) const {
+    return n * (targets.size() / (first_target.size() - 1) + 1); // average number of targets per item
+}
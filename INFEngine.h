@@ -0,0 +1,38 @@
+/* This file is part of the code presented in the paper
+
+	"An Exact Solver for Submodular Knapsack Problems"
+
+by Sabine Münch and Stephen Raach
+==============================================================================*/
+
+#ifndef INFEngine_H
+#define INFEngine_H
+
+#include <vector>
+#include <cstddef>
+#include "ObjectiveEngine.h"
+
+// incremental state for the objective INF
+// surv[j] is the probability that target j is not activated by the current set S, i.e. the product of (1-p[v]) over all v in S connected to j
+// adding c to S activates target j with additional probability p[c]*surv[j], so the marginal gain of c is p[c] * sum of surv[j] over the targets of c
+// the old survival values of the targets of a pushed item are kept in an undo log
+class INFEngine : public ObjectiveEngine {
+public:
+    // state of the empty set, uses the adjacency built by loadData_f3
+    INFEngine();
+
+private:
+    std::vector<float> surv;
+    std::vector<float> undo;        // survival values of the targets of the items in path before they were pushed
+    std::vector<size_t> undo_start; // position in undo of the first value of each item in path
+
+    // p[c] * sum of surv[j] over the targets of c
+    float kernel(int c) const;
+
+    void push(int v) override;
+    void pop() override;
+    void evaluate(const int* C, size_t n, float* out) const override;
+    size_t work(size_t n) const override;
+};
+
+#endif
@@ -0,0 +1,27 @@
+/* This file is part of the code presented in the paper
+
+	"An Exact Solver for Submodular Knapsack Problems"
+
+by Sabine Münch and Stephen Raach
+==============================================================================*/
+
+#include "Incumbent.h"
+
+bool Incumbent::publish(float s_value, const std::vector<int>& S) {
+    if (s_value <= value()) { // cheap test first, most candidates are not better than the incumbent
+        return false;
+    }
+    auto improved = std::make_shared<const Solution>(Solution{s_value, S});
+    auto current = std::atomic_load(&snapshot);
+    while (!current || s_value > current->value) {
+        if (std::atomic_compare_exchange_weak(&snapshot, &current, improved)) {
+            // raise the polled value, other writers may have raised it further in between
+            float old = best.load(std::memory_order_relaxed);
+            while (old < s_value && !best.compare_exchange_weak(old, s_value, std::memory_order_release)) {
+            }
+            versions.fetch_add(1, std::memory_order_release);
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,45 @@
+/* This file is part of the code presented in the paper
+
+	"An Exact Solver for Submodular Knapsack Problems"
+
+by Sabine Münch and Stephen Raach
+==============================================================================*/
+
+#ifndef Incumbent_H
+#define Incumbent_H
+
+#include <vector>
+#include <atomic>
+#include <memory>
+#include <cstdint>
+
+// best solution found so far, shared by all solvers and threads working on the same instance
+// the value is an atomic float that is polled in every search node
+// the solution set is published as an immutable snapshot: readers load the current snapshot and keep it alive as long as they use it,
+// writers replace it by a better one (read-copy-update), so readers never wait for writers
+class Incumbent {
+public:
+    struct Solution {
+        float value;
+        std::vector<int> S;
+    };
+
+    // value of the best solution, 0 if none was published
+    float value() const { return best.load(std::memory_order_acquire); }
+
+    // number of published improvements
+    uint64_t version() const { return versions.load(std::memory_order_acquire); }
+
+    // publishes S with objective value s_value if it improves the incumbent, returns true if it did
+    bool publish(float s_value, const std::vector<int>& S);
+
+    // snapshot of the best solution, nullptr if none was published
+    std::shared_ptr<const Solution> solution() const { return std::atomic_load(&snapshot); }
+
+private:
+    std::atomic<float> best{0.0f};
+    std::atomic<uint64_t> versions{0};
+    std::shared_ptr<const Solution> snapshot;
+};
+
+#endif
@@ -0,0 +1,198 @@
+/* This file is part of the code presented in the paper
+
+	"An Exact Solver for Submodular Knapsack Problems"
+
+by Sabine Münch and Stephen Raach
+==============================================================================*/
+
+#include "LOCEngine.h"
+#include "Load.h"
+#include "Numeric.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <thread>
+#include "Numa.h"
+
+// decoded benefit of a quantized entry
+static inline float decode(uint16_t code, float min, float scale) {
+    return min + code * scale;
+}
+
+LOCEngine::LOCEngine(Storage storage) : storage(storage) {
+    size_t n = benefits.size();
+    m = n > 0 ? benefits[0].size() : 0;
+    stride = (m + 31) / 32 * 32;
+    curmax.assign(stride, std::numeric_limits<float>::lowest());
+
+    row_sum.resize(n);
+    for (size_t c = 0; c < n; ++c) {
+        Accumulator sum; // same sum as f2({c})
+        for (float b : benefits[c]) {
+            sum.add(b);
+        }
+        row_sum[c] = sum.value();
+    }
+
+    if (storage == Storage::UInt16) {
+        // quantize every row to [row_min, row_max] with 16 bit, offset and scale of the rows
+        const float levels = 65000.0f; // below 65535, so there is room to round upwards
+        row_min.resize(n);
+        row_scale.resize(n);
+        for (size_t c = 0; c < n; ++c) {
+            auto [lo, hi] = std::minmax_element(benefits[c].begin(), benefits[c].end());
+            row_min[c] = m > 0 ? *lo : 0.0f;
+            row_scale[c] = (m > 0 && *hi > *lo) ? (*hi - *lo) / levels : 1.0f;
+        }
+    }
+
+    // one copy of the stored rows per node for Replicate, each copy is written (first touch) by a thread pinned to its node
+    size_t copies = (Numa::placement == Numa::Placement::Replicate) ? Numa::nodes() : 1;
+    rows.resize(storage == Storage::Float ? copies : 0);
+    codes.resize(storage == Storage::UInt16 ? copies : 0);
+    if (copies == 1) {
+        fill(0);
+        return;
+    }
+    std::vector<std::thread> workers;
+    for (size_t r = 0; r < copies; ++r) {
+        workers.emplace_back([this, r]() {
+            Numa::pin(Numa::node_cpus(r));
+            fill(r);
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+void LOCEngine::fill(size_t r) {
+    size_t n = benefits.size();
+    if (storage == Storage::Float) {
+        rows[r].assign(n * stride, 0.0f);
+        for (size_t c = 0; c < n; ++c) {
+            std::copy(benefits[c].begin(), benefits[c].end(), rows[r].begin() + c * stride);
+        }
+        return;
+    }
+    // codes are rounded upwards
+    codes[r].assign(n * stride, 0);
+    for (size_t c = 0; c < n; ++c) {
+        for (size_t j = 0; j < m; ++j) {
+            float b = benefits[c][j];
+            uint32_t code = static_cast<uint32_t>(std::ceil((b - row_min[c]) / row_scale[c]));
+            while (code < 65535 && decode(code, row_min[c], row_scale[c]) < b) {
+                code++;
+            }
+            if (code < 65535 && code > 0) { // one step of slack covers the rounding of the decode in the gain kernel
+                code++;
+            }
+            codes[r][c * stride + j] = static_cast<uint16_t>(code);
+        }
+    }
+}
+
+size_t LOCEngine::bytes() const {
+    size_t total = 0;
+    for (const auto& copy : rows) {
+        total += copy.size() * sizeof(float);
+    }
+    for (const auto& copy : codes) {
+        total += copy.size() * sizeof(uint16_t);
+    }
+    return total;
+}
+
+void LOCEngine::push(int v) {
+    undo_start.push_back(undo.size());
+    const std::vector<float>& row = benefits[v];
+    for (size_t j = 0; j < m; ++j) {
+        if (row[j] > curmax[j]) {
+            undo.push_back({static_cast<int>(j), curmax[j]});
+            curmax[j] = row[j];
+        }
+    }
+}
+
+void LOCEngine::pop() {
+    for (size_t u = undo.size(); u > undo_start.back(); --u) {
+        curmax[undo[u - 1].first] = undo[u - 1].second;
+    }
+    undo.resize(undo_start.back());
+    undo_start.pop_back();
+}
+
+// the sum is split into lanes float sums, so the compiler can keep them in one vector register
+static constexpr int lanes = 8;
+
+Sum LOCEngine::blockgain(size_t r, int c, size_t j0, size_t j1) const {
+    const float* cur = curmax.data();
+    Accumulator acc[lanes];
+    for (size_t r0 = j0; r0 < j1; r0 += run) {
+        size_t r1 = std::min(j1, r0 + run);
+        float part[lanes] = {};
+        size_t j = r0;
+        if (storage == Storage::Float) {
+            const float* row = rows[r].data() + c * stride;
+            for (; j + lanes <= r1; j += lanes) {
+                for (int l = 0; l < lanes; ++l) {
+                    float d = row[j + l] - cur[j + l];
+                    part[l] += d > 0.0f ? d : 0.0f;
+                }
+            }
+            for (; j < r1; ++j) {
+                float d = row[j] - cur[j];
+                part[0] += d > 0.0f ? d : 0.0f;
+            }
+        } else { // decode on the fly, the decoded benefit is an upper bound and curmax is exact
+            const uint16_t* row = codes[r].data() + c * stride;
+            float min = row_min[c];
+            float scale = row_scale[c];
+            for (; j + lanes <= r1; j += lanes) {
+                for (int l = 0; l < lanes; ++l) {
+                    float d = decode(row[j + l], min, scale) - cur[j + l];
+                    part[l] += d > 0.0f ? d : 0.0f;
+                }
+            }
+            for (; j < r1; ++j) {
+                float d = decode(row[j], min, scale) - cur[j];
+                part[0] += d > 0.0f ? d : 0.0f;
+            }
+        }
+        for (int l = 0; l < lanes; ++l) {
+            acc[l].add(part[l]);
+        }
+    }
+    Accumulator sum;
+    for (int l = 0; l < lanes; ++l) {
+        sum.add(acc[l].value());
+    }
+    return sum.value();
+}
+
+void LOCEngine::evaluate(const int* C, size_t n, float* out) const {
+    if (path.empty()) { // gains at the empty set, curmax is not defined yet
+        for (size_t k = 0; k < n; ++k) {
+            out[k] = row_sum[C[k]];
+        }
+        return;
+    }
+    size_t copies = std::max(rows.size(), codes.size());
+    size_t r = copies > 1 ? Numa::current_node() % copies : 0; // copy of the rows on the node of this thread
+    // the gains of a group of items are accumulated over all blocks before they are rounded to float
+    constexpr size_t group = 64;
+    for (size_t first = 0; first < n; first += group) {
+        size_t last = std::min(n, first + group);
+        Accumulator gain[group];
+        for (size_t j0 = 0; j0 < m; j0 += block) {
+            size_t j1 = std::min(m, j0 + block);
+            for (size_t k = first; k < last; ++k) {
+                gain[k - first].add(blockgain(r, C[k], j0, j1));
+            }
+        }
+        for (size_t k = first; k < last; ++k) {
+            out[k] = gain[k - first].value();
+        }
+    }
+}
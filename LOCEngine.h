@@ -0,0 +1,78 @@
+/* This file is part of the code presented in the paper
+
+	"An Exact Solver for Submodular Knapsack Problems"
+
+by Sabine Münch and Stephen Raach
+==============================================================================*/
+
+#ifndef LOCEngine_H
+#define LOCEngine_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "functions.h"
+#include "ObjectiveEngine.h"
+#include "Numeric.h"
+
+// incremental state for the objective LOC
+// curmax[j] is the best benefit of customer j in the current set S, the marginal gain of c is the sum of max(0, benefits[c][j] - curmax[j])
+// the marginal gains are upper bounds of the true ones for UInt16 storage
+// changed entries of curmax are kept in an undo log
+//
+// storage of the benefit rows used for the gains:
+// - Float: full precision copy of benefits in one aligned array
+// - UInt16: each row is quantized to 16 bit with an offset and a scale per row, rounded upwards
+//   the decoded benefits are never smaller than the true ones, so the gains are upper bounds of the true marginal gains
+//   all bounds of the search stay valid, f (and hence every solution value) is still computed with full precision
+class LOCEngine : public ObjectiveEngine {
+public:
+    enum class Storage { Float, UInt16 };
+
+    // uses the benefits loaded by loadData_f2
+    explicit LOCEngine(Storage storage = Storage::Float);
+
+    // bytes of the stored benefit rows
+    size_t bytes() const;
+
+private:
+    Storage storage;
+    size_t m;       // number of customers
+    size_t stride;  // row length in the stored arrays, padded to full cache lines
+
+    // stored rows, one copy per NUMA node for Replicate placement, otherwise one copy
+    std::vector<std::vector<float, AlignedAllocator<float>>> rows;         // Float: benefits[c][j] = rows[r][c*stride+j]
+    std::vector<std::vector<uint16_t, AlignedAllocator<uint16_t>>> codes;  // UInt16: benefits[c][j] <= row_min[c] + codes[r][c*stride+j] * row_scale[c]
+    std::vector<float> row_min;
+    std::vector<float> row_scale;
+    std::vector<float> row_sum;  // f({c}), gain of c at the empty set
+
+    std::vector<float, AlignedAllocator<float>> curmax;
+    std::vector<std::pair<int, float>> undo;     // customers whose curmax was raised and their old curmax
+    std::vector<size_t> undo_start;              // position in undo of the first entry of each item in path
+
+    static constexpr size_t block = 2048; // customers per block, 8KB of curmax
+
+    // customers summed up in float lanes by blockgain before the lanes are added to the accumulators (blocked summation)
+    // the hot loop is the same for all numeric policies, with float sums the lanes are the accumulators
+#if defined(PRECISION_DOUBLE) || defined(PRECISION_KAHAN)
+    static constexpr size_t run = 256;
+#else
+    static constexpr size_t run = block;
+#endif
+
+    // writes copy r of the stored rows
+    void fill(size_t r);
+
+    // sum of max(0, benefit[c][j] - curmax[j]) over the customers j0 <= j < j1, read from copy r of the rows
+    Sum blockgain(size_t r, int c, size_t j0, size_t j1) const;
+
+    void push(int v) override;
+    void pop() override;
+    // gains of C[0], ..., C[n-1] at the current state, the customers are processed in blocks that stay in cache
+    // each block of curmax is used for all items before the next block is loaded
+    void evaluate(const int* C, size_t n, float* out) const override;
+    size_t work(size_t n) const override { return n * m; }
+};
+
+#endif
@@ -18,6 +18,8 @@ std::vector<int> weights;
 // global variables for COV
 std::vector<std::set<int>> districts;
 std::vector<float> values;
+std::vector<int> first_element;
+std::vector<int> elements;
 
 // global variables for LOC
 std::vector<std::vector<float>> benefits;
@@ -26,6 +28,8 @@ std::vector<std::vector<float>> benefits;
 std::vector<float> p;  
 std::vector<std::vector<float>> connections;
 int m;
+std::vector<int> first_target;
+std::vector<int> targets;
 
 // load COV data
 void loadData_f1() {
@@ -58,6 +62,14 @@ void loadData_f1() {
         districts.push_back(dset);
     }
 
+    // adjacency of the items, built from the sets
+    first_element.assign(1, 0);
+    elements.clear();
+    for (const auto& dset : districts) {
+        elements.insert(elements.end(), dset.begin(), dset.end());
+        first_element.push_back(elements.size());
+    }
+
     weights.clear();
     for (const auto& weight : weight_sets) {
         int int_weight = static_cast<int>(weight.get<float>());
@@ -106,6 +118,18 @@ void loadData_f3() {
     int U = connections.size();
     m = connections[0].size();
 
+    // adjacency of the sources, built from the rows of the connection matrix
+    first_target.assign(1, 0);
+    targets.clear();
+    for (int v = 0; v < U; ++v) {
+        for (int j = 0; j < m; ++j) {
+            if (connections[v][j] == 1) {
+                targets.push_back(j);
+            }
+        }
+        first_target.push_back(targets.size());
+    }
+
     weights.clear();  
     
     // Prepare weights for the knapsack
@@ -18,6 +18,9 @@ extern std::vector<int> weights;
 // global variables for COV
 extern std::vector<std::set<int>> districts;
 extern std::vector<float> values;
+// adjacency of the items: the elements covered by item v are elements[first_element[v]], ..., elements[first_element[v+1]-1] in increasing order
+extern std::vector<int> first_element;
+extern std::vector<int> elements;
 
 // global variables for LOC
 extern std::vector<std::vector<float>> benefits;
@@ -26,6 +29,9 @@ extern std::vector<std::vector<float>> benefits;
 extern std::vector<float> p;  
 extern std::vector<std::vector<float>> connections;
 extern int m;
+// adjacency of the sources: the targets of source v are targets[first_target[v]], ..., targets[first_target[v+1]-1]
+extern std::vector<int> first_target;
+extern std::vector<int> targets;
 
 using LoadFunction = std::function<void()>;
 extern LoadFunction loadData;
@@ -0,0 +1,124 @@
+/* This file is part of the code presented in the paper
+
+	"An Exact Solver for Submodular Knapsack Problems"
+
+by Sabine Münch and Stephen Raach
+==============================================================================*/
+
+#include "Numa.h"
+#include <fstream>
+#include <sstream>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+Numa::Placement Numa::placement = Numa::Placement::Default;
+std::vector<int> Numa::cpus;
+
+// memory policies of the set_mempolicy system call (linux/mempolicy.h)
+static const int MPOL_DEFAULT_ = 0;
+static const int MPOL_INTERLEAVE_ = 3;
+
+int Numa::nodes() {
+    int count = 0;
+    while (std::ifstream("/sys/devices/system/node/node" + std::to_string(count) + "/cpulist")) {
+        count++;
+    }
+    return count > 0 ? count : 1;
+}
+
+std::vector<int> Numa::node_cpus(int node) {
+    std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+    std::string list;
+    if (!(file >> list)) { // unknown topology: all CPUs belong to node 0
+        std::vector<int> all;
+        for (long cpu = 0, n = sysconf(_SC_NPROCESSORS_ONLN); cpu < n; ++cpu) {
+            all.push_back(cpu);
+        }
+        return all;
+    }
+    return parse_cpus(list);
+}
+
+int Numa::current_node() {
+    unsigned cpu = 0, node = 0;
+    if (syscall(SYS_getcpu, &cpu, &node, nullptr) != 0) {
+        return 0;
+    }
+    return node;
+}
+
+std::vector<int> Numa::parse_cpus(const std::string& list) {
+    std::vector<int> result;
+    std::stringstream stream(list);
+    std::string range;
+    while (std::getline(stream, range, ',')) {
+        if (range.empty()) {
+            continue;
+        }
+        size_t dash = range.find('-');
+        int first = std::stoi(range.substr(0, dash));
+        int last = (dash == std::string::npos) ? first : std::stoi(range.substr(dash + 1));
+        for (int cpu = first; cpu <= last; ++cpu) {
+            result.push_back(cpu);
+        }
+    }
+    return result;
+}
+
+std::string Numa::format_cpus(const std::vector<int>& cpus) {
+    if (cpus.empty()) {
+        return "none";
+    }
+    std::string result;
+    for (size_t i = 0; i < cpus.size(); ++i) {
+        size_t j = i;
+        while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1) {
+            j++;
+        }
+        result += (result.empty() ? "" : ",") + std::to_string(cpus[i]);
+        if (j > i) {
+            result += "-" + std::to_string(cpus[j]);
+        }
+        i = j;
+    }
+    return result;
+}
+
+std::string Numa::name(Placement placement) {
+    switch (placement) {
+        case Placement::Interleave: return "interleave";
+        case Placement::Replicate: return "replicate";
+        default: return "default";
+    }
+}
+
+bool Numa::pin(const std::vector<int>& cpus) {
+    if (cpus.empty()) {
+        return false;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus) {
+        CPU_SET(cpu, &set);
+    }
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+}
+
+void Numa::pin_worker(unsigned w) {
+    if (!cpus.empty()) {
+        pin({cpus[w % cpus.size()]});
+    }
+}
+
+bool Numa::interleave(bool on) {
+    if (!on) {
+        return syscall(SYS_set_mempolicy, MPOL_DEFAULT_, nullptr, 0) == 0;
+    }
+    unsigned long mask = 0;
+    int n = nodes();
+    for (int node = 0; node < n && node < 64; ++node) {
+        mask |= 1ul << node;
+    }
+    return syscall(SYS_set_mempolicy, MPOL_INTERLEAVE_, &mask, 65) == 0;
+}
@@ -0,0 +1,63 @@
+/* This file is part of the code presented in the paper
+
+	"An Exact Solver for Submodular Knapsack Problems"
+
+by Sabine Münch and Stephen Raach
+==============================================================================*/
+
+#ifndef Numa_H
+#define Numa_H
+
+#include <vector>
+#include <string>
+
+// NUMA topology, memory placement and thread pinning (Linux)
+// the topology is read from /sys/devices/system/node, memory policies are set with the set_mempolicy system call
+// on systems without NUMA support everything degrades to a single node and placement requests are ignored
+class Numa {
+public:
+    // placement of the instance storage (the rows and adjacency arrays used by the objective engines)
+    // Default: first touch, the pages are placed on the node of the thread that initializes them
+    // Interleave: pages are spread round robin over all nodes
+    // Replicate: the LOC benefit rows are copied once per node, each copy is initialized by a thread pinned to its node
+    enum class Placement { Default, Interleave, Replicate };
+
+    static Placement placement;
+    // CPUs for the solver thread and the worker threads, empty if threads are not pinned
+    static std::vector<int> cpus;
+
+    // number of NUMA nodes, 1 if the topology is unknown
+    static int nodes();
+    // CPUs of a node
+    static std::vector<int> node_cpus(int node);
+    // node of the CPU the calling thread is running on
+    static int current_node();
+
+    // parses a CPU list like "0-3,8,10-11"
+    static std::vector<int> parse_cpus(const std::string& list);
+    static std::string format_cpus(const std::vector<int>& cpus);
+    static std::string name(Placement placement);
+
+    // pins the calling thread to the given CPUs, returns false if that is not possible
+    static bool pin(const std::vector<int>& cpus);
+    // pins worker w to cpus[w mod |cpus|] if CPUs are configured
+    static void pin_worker(unsigned w);
+
+    // interleave the pages allocated from now on by the calling thread over all nodes (on = true) or go back to first touch (on = false)
+    static bool interleave(bool on);
+};
+
+// sets the interleave policy for the calling thread while the scope is alive, if the placement is Interleave
+class InterleaveScope {
+public:
+    InterleaveScope() : active(Numa::placement == Numa::Placement::Interleave && Numa::interleave(true)) {}
+    ~InterleaveScope() { if (active) Numa::interleave(false); }
+
+    InterleaveScope(const InterleaveScope&) = delete;
+    InterleaveScope& operator=(const InterleaveScope&) = delete;
+
+private:
+    bool active;
+};
+
+#endif
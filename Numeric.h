@@ -0,0 +1,42 @@
+/* This file is part of the code presented in the paper
+
+	"An Exact Solver for Submodular Knapsack Problems"
+
+by Sabine Münch and Stephen Raach
+==============================================================================*/
+
+#ifndef Numeric_H
+#define Numeric_H
+
+// numeric policy of the objective sums, selected at compile time (make PRECISION=float|double|kahan)
+// float: sums are accumulated in float (default)
+// double: sums are accumulated in double, values and gains are still stored as float
+// kahan: sums are accumulated in float with compensated summation
+// f1, f2, f3 and the gain kernels of the engines add up their terms with an Accumulator
+#if defined(PRECISION_DOUBLE)
+using Sum = double;
+#else
+using Sum = float;
+#endif
+
+struct Accumulator {
+    Sum sum = 0;
+#ifdef PRECISION_KAHAN
+    Sum carry = 0; // rounding error of the last addition, it is subtracted from the next term
+#endif
+
+    void add(Sum x) {
+#ifdef PRECISION_KAHAN
+        Sum y = x - carry;
+        Sum t = sum + y;
+        carry = (t - sum) - y;
+        sum = t;
+#else
+        sum += x;
+#endif
+    }
+
+    Sum value() const { return sum; }
+};
+
+#endif
@@ -0,0 +1,138 @@
+/* This file is part of the code presented in the paper
+
+	"An Exact Solver for Submodular Knapsack Problems"
+
+by Sabine Münch and Stephen Raach
+==============================================================================*/
+
+#include "ObjectiveEngine.h"
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <unistd.h>
+#include "Numa.h"
+
+// workers of the gain threads, started once and woken for every wide node
+// a node is split into parts chunks, the calling thread evaluates chunk 0 and worker w evaluates chunk w+1
+struct ObjectiveEngine::Pool {
+    std::vector<std::thread> workers;
+    pid_t pid = getpid(); // threads do not survive fork, a worker process starts its own pool
+    std::mutex mutex;
+    std::condition_variable start, done;
+    unsigned long generation = 0; // number of the current node, a worker waits for the next one
+    size_t pending = 0;           // workers that have not finished the current node
+    bool stop = false;
+    // current node
+    const int* C = nullptr;
+    float* out = nullptr;
+    size_t n = 0;
+    size_t chunk = 0;
+};
+
+void ObjectiveEngine::sync(const std::vector<int>& S) {
+    size_t common = 0;
+    while (common < path.size() && common < S.size() && path[common] == S[common]) {
+        common++;
+    }
+    while (path.size() > common) {
+        pop();
+        path.pop_back();
+    }
+    for (size_t i = common; i < S.size(); ++i) {
+        push(S[i]);
+        path.push_back(S[i]);
+    }
+}
+
+float ObjectiveEngine::gain(const std::vector<int>& S, int c) {
+    sync(S);
+    float value;
+    evaluate(&c, 1, &value);
+    return value;
+}
+
+ObjectiveEngine::ObjectiveEngine() = default;
+
+ObjectiveEngine::~ObjectiveEngine() {
+    setthreads(1);
+}
+
+void ObjectiveEngine::setthreads(unsigned threads, unsigned first) {
+    if (pool) { // stop the workers of the previous setting
+        if (pool->pid == getpid()) {
+            {
+                std::lock_guard<std::mutex> lock(pool->mutex);
+                pool->stop = true;
+            }
+            pool->start.notify_all();
+            for (std::thread& worker : pool->workers) {
+                worker.join();
+            }
+        }
+        else { // the workers belong to the parent process, only their memory is left
+            static_cast<void>(pool.release());
+        }
+        pool.reset();
+    }
+    count = std::max(1u, threads);
+    this->first = first;
+    if (count == 1) {
+        return;
+    }
+    pool = std::make_unique<Pool>();
+    for (unsigned w = 0; w + 1 < count; ++w) {
+        pool->workers.emplace_back([this, w, first, state = pool.get()]() {
+            Numa::pin_worker(first + w);
+            unsigned long seen = 0;
+            while (true) {
+                std::unique_lock<std::mutex> lock(state->mutex);
+                state->start.wait(lock, [&]() { return state->stop || state->generation != seen; });
+                if (state->stop) {
+                    return;
+                }
+                seen = state->generation;
+                const int* C = state->C;
+                float* out = state->out;
+                size_t n = state->n;
+                size_t chunk = state->chunk;
+                lock.unlock();
+                size_t first = (w + 1) * chunk;
+                if (first < n) {
+                    evaluate(C + first, std::min(chunk, n - first), out + first);
+                }
+                lock.lock();
+                if (--state->pending == 0) {
+                    state->done.notify_one();
+                }
+            }
+        });
+    }
+}
+
+void ObjectiveEngine::gains(const std::vector<int>& S, const int* C, size_t n, float* out) {
+    sync(S);
+    // threads only pay off if the node reads enough data
+    size_t parts = std::min<size_t>(count, work(n) / (1 << 18) + 1);
+    if (parts <= 1) {
+        evaluate(C, n, out);
+        return;
+    }
+    if (pool->pid != getpid()) { // forked worker process, start the threads again
+        setthreads(count, first);
+    }
+    size_t chunk = (n + parts - 1) / parts;
+    {
+        std::lock_guard<std::mutex> lock(pool->mutex);
+        pool->C = C;
+        pool->out = out;
+        pool->n = n;
+        pool->chunk = chunk;
+        pool->pending = pool->workers.size();
+        pool->generation++;
+    }
+    pool->start.notify_all();
+    evaluate(C, std::min(chunk, n), out);
+    std::unique_lock<std::mutex> lock(pool->mutex);
+    pool->done.wait(lock, [&]() { return pool->pending == 0; });
+}
@@ -0,0 +1,58 @@
+/* This file is part of the code presented in the paper
+
+	"An Exact Solver for Submodular Knapsack Problems"
+
+by Sabine Münch and Stephen Raach
+==============================================================================*/
+
+#ifndef ObjectiveEngine_H
+#define ObjectiveEngine_H
+
+#include <vector>
+#include <memory>
+#include <cstddef>
+
+// incremental state of an objective function for the set S on the current path of the search
+// the state is moved to the S of a query by popping and pushing only the items behind the common prefix with the current set
+// marginal gains are evaluated from the state, for a single item or for a batch of items
+// derived classes: COVEngine, LOCEngine, INFEngine
+class ObjectiveEngine {
+public:
+    ObjectiveEngine();
+    virtual ~ObjectiveEngine();
+
+    // marginal gain f(S+c)-f(S)
+    float gain(const std::vector<int>& S, int c);
+
+    // marginal gains of the n items C[0], ..., C[n-1] at S, out[k] is the same value as gain(S, C[k])
+    // if more than one thread is given, the items of wide nodes are split over the threads
+    void gains(const std::vector<int>& S, const int* C, size_t n, float* out);
+
+    // moves the state to S
+    void sync(const std::vector<int>& S);
+
+    // threads for gains of wide nodes, the calling thread and threads-1 workers that are started here and wait for the chunks of the nodes
+    // worker w is pinned with Numa::pin_worker(first + w), so the workers do not share the CPUs of the solver threads if first is behind them
+    void setthreads(unsigned threads, unsigned first = 0);
+    unsigned threads() const { return count; }
+
+protected:
+    std::vector<int> path; // current set S
+
+    // add v to the state, v is appended to path afterwards
+    virtual void push(int v) = 0;
+    // remove path.back() from the state, it is removed from path afterwards
+    virtual void pop() = 0;
+    // gains of C[0], ..., C[n-1] at the current state
+    virtual void evaluate(const int* C, size_t n, float* out) const = 0;
+    // number of values read to evaluate n items, decides if threads pay off
+    virtual size_t work(size_t n) const = 0;
+
+private:
+    struct Pool;
+    std::unique_ptr<Pool> pool; // workers of the gain threads, nullptr for a single thread
+    unsigned count = 1;
+    unsigned first = 0;
+};
+
+#endif
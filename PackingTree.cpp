@@ -0,0 +1,131 @@
+/* This file is part of the code presented in the paper
+
+	"An Exact Solver for Submodular Knapsack Problems"
+
+by Sabine Münch and Stephen Raach
+==============================================================================*/
+
+#include "PackingTree.h"
+
+// recomputes weight, value and last gain of subtree t from its children
+void PackingTree::update(int t) {
+    Node& node = nodes[t];
+    node.sum_weight = node.weight;
+    node.sum_value = node.value;
+    node.last_gain = node.gain;
+    if (node.left >= 0) {
+        node.sum_weight += nodes[node.left].sum_weight;
+        node.sum_value = nodes[node.left].sum_value + node.sum_value;
+    }
+    if (node.right >= 0) {
+        node.sum_weight += nodes[node.right].sum_weight;
+        node.sum_value += nodes[node.right].sum_value;
+        node.last_gain = nodes[node.right].last_gain;
+    }
+}
+
+void PackingTree::split(int t, float gain, int& left, int& right) {
+    if (t < 0) {
+        left = right = -1;
+        return;
+    }
+    if (nodes[t].gain >= gain) { // t and its left subtree stay in front of gain
+        int l, r;
+        split(nodes[t].right, gain, l, r);
+        nodes[t].right = l;
+        update(t);
+        left = t;
+        right = r;
+    } else {
+        int l, r;
+        split(nodes[t].left, gain, l, r);
+        nodes[t].left = r;
+        update(t);
+        left = l;
+        right = t;
+    }
+}
+
+int PackingTree::merge(int left, int right) {
+    if (left < 0) return right;
+    if (right < 0) return left;
+    if (nodes[left].priority > nodes[right].priority) {
+        nodes[left].right = merge(nodes[left].right, right);
+        update(left);
+        return left;
+    }
+    nodes[right].left = merge(left, nodes[right].left);
+    update(right);
+    return right;
+}
+
+void PackingTree::insert(int c, float gain, int weight) {
+    // xorshift for the heap priorities of the treap
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+
+    Node node;
+    node.item = c;
+    node.gain = gain;
+    node.weight = weight;
+    node.value = gain * weight;
+    node.priority = seed;
+    nodes.push_back(node);
+    int t = nodes.size() - 1;
+    update(t);
+
+    int left, right;
+    split(root, gain, left, right);
+    root = merge(merge(left, t), right);
+}
+
+// same packing as the greedy over a max-heap: items are packed while they fit, the next item is packed fractional
+// the descent skips every left subtree that fits completely
+std::pair<float, float> PackingTree::track(int capacity) const {
+    float total_value = 0.0f; // knapsack value
+    float schranke = 0.0f; // current gain of last packed item
+    int t = root;
+    while (t >= 0) {
+        const Node& node = nodes[t];
+        if (node.left >= 0) {
+            const Node& left = nodes[node.left];
+            if (left.sum_weight > capacity) { // first item that does not fit is in the left subtree
+                t = node.left;
+                continue;
+            }
+            capacity -= left.sum_weight; // pack left subtree
+            total_value += left.sum_value;
+            schranke = left.last_gain;
+        }
+        if (node.weight <= capacity) { // pack item of node and continue in the right subtree
+            capacity -= node.weight;
+            total_value += node.value;
+            schranke = node.gain;
+            t = node.right;
+        } else {
+            if (capacity > 0) { // add fractional part of the item if capacity is left
+                total_value += node.gain * capacity;
+                schranke = node.gain;
+            }
+            break;
+        }
+    }
+    return {total_value, schranke};
+}
+
+void PackingTree::sorted(std::pmr::vector<int>& C) const {
+    // iterative in-order traversal
+    std::pmr::vector<int> stack(nodes.get_allocator().resource());
+    int t = root;
+    while (t >= 0 || !stack.empty()) {
+        while (t >= 0) {
+            stack.push_back(t);
+            t = nodes[t].left;
+        }
+        t = stack.back();
+        stack.pop_back();
+        C.push_back(nodes[t].item);
+        t = nodes[t].right;
+    }
+}
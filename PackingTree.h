@@ -0,0 +1,61 @@
+/* This file is part of the code presented in the paper
+
+	"An Exact Solver for Submodular Knapsack Problems"
+
+by Sabine Münch and Stephen Raach
+==============================================================================*/
+
+#ifndef PackingTree_H
+#define PackingTree_H
+
+#include <vector>
+#include <memory_resource>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+
+// greedy order for Early Pruning
+// balanced search tree (treap) of items ordered according to decreasing current gain
+// each node stores the weight and value of its subtree, so the fractional knapsack can be packed in logarithmic time
+class PackingTree {
+public:
+    explicit PackingTree(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) : nodes(resource) {}
+
+    // insert item c with current gain and weight, items with equal gain are ordered by insertion
+    void insert(int c, float gain, int weight);
+
+    // packs fractional knapsack according to relative marginal gain and tracks the current gain of the last packed item
+    // Output: value of packed knapsack, current gain of item packed last into the knapsack
+    std::pair<float, float> track(int capacity) const;
+
+    // appends all items in greedy order to C
+    void sorted(std::pmr::vector<int>& C) const;
+
+    void reserve(size_t n) { nodes.reserve(n); }
+    bool empty() const { return root < 0; }
+
+private:
+    struct Node {
+        int item;
+        float gain;      // current gain of item
+        int weight;      // weight of item
+        float value;     // current gain * weight
+        uint32_t priority;
+        int left = -1;
+        int right = -1;
+        int sum_weight;  // weight of subtree
+        float sum_value; // value of subtree
+        float last_gain; // current gain of the last item of subtree in greedy order
+    };
+
+    std::pmr::vector<Node> nodes;
+    int root = -1;
+    uint32_t seed = 2463534242u;
+
+    void update(int t);
+    // splits subtree t into items with gain >= gain (left) and gain < gain (right)
+    void split(int t, float gain, int& left, int& right);
+    int merge(int left, int right);
+};
+
+#endif
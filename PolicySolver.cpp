@@ -0,0 +1,142 @@
+/* This file is part of the code presented in the paper
+
+	"An Exact Solver for Submodular Knapsack Problems"
+
+by Sabine Münch and Stephen Raach
+==============================================================================*/
+
+#include "PolicySolver.h"
+#include <vector>
+#include <cmath>
+
+template<class Ordering, class Pruning, class Reduction>
+float PolicySolver<Ordering, Pruning, Reduction>::search(std::vector<int>& S, const Candidates& C, const Candidates& parent_C, int B, float s_best, int s_weight, const Gains* previous_gains) {
+    TraceNode node(trace, S, C.size(), oracle_calls); // record of this node, written on backtrack if a trace is recorded
+    if (stopped()) { //if time limit exceeded or another solver of the portfolio finished, return -1
+        node.prune(Trace::Reason::Time, s_best);
+        return -1.0f;
+    }
+
+    counter++;
+    ArenaScope scope(arena); // buffers of this node are released on backtrack
+
+    float s_value = value(S, s_best); // update objective value of current solution set, from the gain cache if possible
+
+    s_best = improve(S, s_value, s_best); // update best solution, also with the shared incumbent
+    node.value(s_value, s_best, B - s_weight);
+
+    if (C.empty()) { // if C is empty, a leaf node is reached and s_best returned
+        node.prune(Trace::Reason::Leaf, s_best);
+        return s_best;
+    }
+
+    int capacity = B - s_weight; // update left capacity
+
+    if (capacity == 0) { // if no capacity is left, return best solution
+        node.prune(Trace::Reason::Capacity, s_best);
+        return s_best;
+    }
+
+    Candidates new_C(&arena); // candidates that fit, ordered according to their current gains
+    Gains current_gains(&arena); // relative gains of the candidates, empty for DCO with SUB (the item values are the gains)
+    const Gains* gains = (Ordering::lazy || Pruning::early) ? &current_gains : nullptr;
+    float sub = NAN; // bound of the node, only known from the DP bound for Early Pruning
+    size_t split = 0; // the knapsack set for candidate reduction is the prefix of new_C up to split
+
+    if constexpr (Pruning::early) {
+        // apply early pruning while the gains are evaluated
+        bool status;
+        std::tie(status, new_C, current_gains) = Ordering::earlypruning(*this, S, C, parent_C, s_value, s_best, capacity, previous_gains);
+        if (status) { // the node can be pruned
+            node.prune(Trace::Reason::EP, s_best);
+            return s_best;
+        }
+        node.candidates(new_C, items.weight.data(), current_gains);
+        if constexpr (Reduction::enabled) {
+            split = packedsplit(new_C, capacity);
+        }
+    }
+    else {
+        // delete items from the candidate set if they can not fit and order the remaining items according to (lazy) relative marginal gain
+        size_t sorted;
+        std::tie(new_C, current_gains, sorted) = Ordering::candidates(*this, S, C, parent_C, s_value, s_best, capacity, previous_gains);
+
+        // Check with a heuristic if the current node can be pruned
+        if constexpr (Reduction::enabled) {
+            auto [bound, packed] = Ordering::boundsplit(*this, new_C, capacity, current_gains);
+            sub = s_value + bound;
+            split = packed;
+        }
+        else {
+            sub = s_value + Ordering::bound(*this, new_C, capacity, current_gains);
+        }
+        if constexpr (Ordering::lazy) {
+            node.candidates(new_C, items.weight.data(), current_gains);
+        }
+        else {
+            node.candidates(new_C, items.weight.data(), items.value.data(), items.inv_weight.data());
+        }
+        if (pruned(sub, s_best)) { // if the current objective value + upper bound is less than current best, we can prune the node
+            node.prune(Trace::Reason::SUB, s_best, sub);
+            return s_best;
+        }
+
+        order(new_C, sorted, gains); // the node is not pruned, order the remaining items
+    }
+
+    // apply candidate reduction
+    size_t reduced = new_C.size();
+    if constexpr (Reduction::enabled) {
+        if constexpr (Pruning::early) {
+            CRep(new_C, s_value, split, s_best, capacity, current_gains);
+        }
+        else {
+            Ordering::reduce(*this, new_C, s_value, split, s_best, capacity, current_gains);
+        }
+    }
+
+    // DP bound if the knapsack table of the candidates is small
+    KnapsackDP dp = knapsack(new_C, capacity, gains);
+    if (dp.rows > 0) {
+        sub = s_value + dp.at(0, capacity);
+        if (pruned(sub, s_best)) {
+            node.prune(Trace::Reason::DP, s_best, sub);
+            return s_best;
+        }
+    }
+
+    node.branch(s_best, sub, reduced - new_C.size());
+    for (size_t i = 0, n = new_C.size(); i < n; ++i) { // iterate over all items in the candidate set
+        if (dp.rows > 0 && pruned(s_value + dp.child(i), s_best)) { // S+item i can not improve s_best, bounded with the gains of this node
+            continue;
+        }
+        ArenaScope child_scope(arena); // candidate set of the child is released after the child is searched
+        Candidates child_C(new_C.begin() + i + 1, new_C.end(), &arena);
+        S.push_back(new_C[i]); // S+item i
+        // recursiv call of search
+        s_best = search(S, child_C, new_C, B, s_best, s_weight + items.weight[new_C[i]], gains);
+        S.pop_back();
+    }
+    return s_best;
+}
+
+template<class Ordering, class Pruning, class Reduction>
+float PolicySolver<Ordering, Pruning, Reduction>::solve(std::vector<int>& S, const std::vector<int>& C, int B) {
+    Candidates root_C(C.begin(), C.end(), &arena);
+    float s_best = search(S, root_C, Candidates(&arena), B, 0, weight(S), nullptr);
+    return s_best;
+}
+
+// all combinations of the policies
+template class PolicySolver<DCOOrdering, SUBPruning, NoReduction>;
+template class PolicySolver<DCOOrdering, SUBPruning, CandidateReduction>;
+template class PolicySolver<DCOOrdering, EarlyPruning, NoReduction>;
+template class PolicySolver<DCOOrdering, EarlyPruning, CandidateReduction>;
+template class PolicySolver<LEOrdering, SUBPruning, NoReduction>;
+template class PolicySolver<LEOrdering, SUBPruning, CandidateReduction>;
+template class PolicySolver<LEOrdering, EarlyPruning, NoReduction>;
+template class PolicySolver<LEOrdering, EarlyPruning, CandidateReduction>;
+template class PolicySolver<LEgOrdering, SUBPruning, NoReduction>;
+template class PolicySolver<LEgOrdering, SUBPruning, CandidateReduction>;
+template class PolicySolver<LEgOrdering, EarlyPruning, NoReduction>;
+template class PolicySolver<LEgOrdering, EarlyPruning, CandidateReduction>;
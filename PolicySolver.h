@@ -0,0 +1,125 @@
+/* This file is part of the code presented in the paper
+
+	"An Exact Solver for Submodular Knapsack Problems"
+
+by Sabine Münch and Stephen Raach
+==============================================================================*/
+
+#ifndef PolicySolver_H
+#define PolicySolver_H
+
+#include "functions.h"
+#include <tuple>
+
+// branch-and-bound search composed of three policies, chosen at compile time:
+// Ordering: how the candidates of a node are filtered, evaluated and ordered (DCO, LE with average decision rule, LE with greedy decision rule)
+// Pruning: how a node is bounded (SUB after ordering, or Early Pruning while the gains are evaluated)
+// Reduction: candidate reduction of the nodes that are not pruned (none or CR)
+// steps of a disabled policy are removed by if constexpr, the DP bound, the gain cache and the trace are part of every combination
+
+// dynamic candidate ordering, the gains of all candidates are evaluated at every node
+struct DCOOrdering {
+    static constexpr bool lazy = false; // SUB uses the item values, no gains are passed to the children
+
+    static std::tuple<Candidates, Gains, size_t> candidates(Solver& solver, const std::vector<int>& S, const Candidates& C, const Candidates&, float s_value, float, int capacity, const Gains*) {
+        auto [new_C, sorted] = solver.DCO(S, C, s_value, capacity);
+        return {std::move(new_C), Gains(&solver.arena), sorted};
+    }
+
+    static std::tuple<bool, Candidates, Gains> earlypruning(Solver& solver, const std::vector<int>& S, const Candidates& C, const Candidates&, float s_value, float s_best, int capacity, const Gains* previous_gains) {
+        return solver.EP(S, C, s_value, s_best, capacity, previous_gains);
+    }
+
+    static float bound(Solver& solver, const Candidates& C, int capacity, const Gains&) {
+        return solver.SUB(C, capacity);
+    }
+
+    static std::pair<float, size_t> boundsplit(Solver& solver, const Candidates& C, int capacity, const Gains&) {
+        return solver.SUB_CR(C, capacity);
+    }
+
+    static void reduce(Solver& solver, Candidates& C, float s_value, size_t split, float s_best, int capacity, const Gains&) {
+        solver.CR(C, s_value, split, s_best, capacity);
+    }
+};
+
+// Lazy Evaluations with average decision rule, only candidates with a previous gain above (s_best - f(S)) / capacity are evaluated
+struct LEOrdering {
+    static constexpr bool lazy = true;
+
+    static std::tuple<Candidates, Gains, size_t> candidates(Solver& solver, const std::vector<int>& S, const Candidates& C, const Candidates&, float s_value, float s_best, int capacity, const Gains* previous_gains) {
+        return solver.LE(S, C, s_value, s_best, capacity, previous_gains);
+    }
+
+    static std::tuple<bool, Candidates, Gains> earlypruning(Solver& solver, const std::vector<int>& S, const Candidates& C, const Candidates&, float s_value, float s_best, int capacity, const Gains* previous_gains) {
+        return solver.LEEP(S, C, s_value, s_best, capacity, previous_gains);
+    }
+
+    static float bound(Solver& solver, const Candidates& C, int capacity, const Gains& current_gains) {
+        return solver.SUB_LE(C, capacity, current_gains);
+    }
+
+    static std::pair<float, size_t> boundsplit(Solver& solver, const Candidates& C, int capacity, const Gains& current_gains) {
+        return solver.SUB_LECR(C, capacity, current_gains);
+    }
+
+    static void reduce(Solver& solver, Candidates& C, float s_value, size_t split, float s_best, int capacity, const Gains& current_gains) {
+        solver.CR_LE(C, s_value, split, s_best, capacity, current_gains);
+    }
+};
+
+// Lazy Evaluations with greedy decision rule, only candidates in front of the greedy knapsack of the parent node are evaluated
+struct LEgOrdering : LEOrdering {
+    static std::tuple<Candidates, Gains, size_t> candidates(Solver& solver, const std::vector<int>& S, const Candidates& C, const Candidates& parent_C, float s_value, float s_best, int capacity, const Gains* previous_gains) {
+        return solver.LEg(S, C, parent_C, s_value, s_best, capacity, previous_gains);
+    }
+
+    static std::tuple<bool, Candidates, Gains> earlypruning(Solver& solver, const std::vector<int>& S, const Candidates& C, const Candidates& parent_C, float s_value, float s_best, int capacity, const Gains* previous_gains) {
+        return solver.LEEP(S, C, s_value, s_best, capacity, previous_gains, &parent_C);
+    }
+};
+
+// nodes are pruned with SUB after the candidates are ordered
+struct SUBPruning {
+    static constexpr bool early = false;
+};
+
+// nodes are pruned while the gains are evaluated, the node has no bound unless the DP bound is computed
+struct EarlyPruning {
+    static constexpr bool early = true;
+};
+
+struct NoReduction {
+    static constexpr bool enabled = false;
+};
+
+// candidates that can not improve the best value together with the knapsack set of the node are removed
+struct CandidateReduction {
+    static constexpr bool enabled = true;
+};
+
+template<class Ordering, class Pruning, class Reduction>
+class PolicySolver : public Solver {
+public:
+    float solve(std::vector<int>& S, const std::vector<int>& C, int B);
+
+private:
+    // search: Input solution set S, candidate set C, candidate set of the parent node parent_C, capacity B, value of currently best solution s_best, weight of S s_weight, gains of C at the parent node
+    float search(std::vector<int>& S, const Candidates& C, const Candidates& parent_C, int B, float s_best, int s_weight, const Gains* previous_gains);
+};
+
+// solvers of main, the type y of each solver is given in makeSolver, all combinations are instantiated in PolicySolver.cpp
+using DCOSUBSolver = PolicySolver<DCOOrdering, SUBPruning, NoReduction>;
+using ACRSolver = PolicySolver<DCOOrdering, SUBPruning, CandidateReduction>;
+using LESolver = PolicySolver<LEOrdering, SUBPruning, NoReduction>;
+using EPSolver = PolicySolver<DCOOrdering, EarlyPruning, NoReduction>;
+using LECRSolver = PolicySolver<LEOrdering, SUBPruning, CandidateReduction>;
+using EPCRSolver = PolicySolver<DCOOrdering, EarlyPruning, CandidateReduction>;
+using LEEPSolver = PolicySolver<LEOrdering, EarlyPruning, NoReduction>;
+using LEEPCRSolver = PolicySolver<LEOrdering, EarlyPruning, CandidateReduction>;
+using LEgSolver = PolicySolver<LEgOrdering, SUBPruning, NoReduction>;
+using LEgCRSolver = PolicySolver<LEgOrdering, SUBPruning, CandidateReduction>;
+using LEgEPSolver = PolicySolver<LEgOrdering, EarlyPruning, NoReduction>;
+using LEgEPCRSolver = PolicySolver<LEgOrdering, EarlyPruning, CandidateReduction>;
+
+#endif
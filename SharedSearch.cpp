@@ -0,0 +1,287 @@
+/* This file is part of the code presented in the paper
+
+	"An Exact Solver for Submodular Knapsack Problems"
+
+by Sabine Münch and Stephen Raach
+==============================================================================*/
+
+#include "SharedSearch.h"
+#include "functions.h"
+#include "Numa.h"
+#include <atomic>
+#include <map>
+#include <new>
+#include <string>
+#include <iostream>
+#include <cerrno>
+#include <pthread.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+
+// the atomics are used by several processes, this only works if they do not need a lock
+static_assert(std::atomic<float>::is_always_lock_free, "atomic float must be lock free");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "atomic uint64_t must be lock free");
+
+// failed searches of a task before it is abandoned
+static constexpr uint8_t max_attempts = 3;
+
+// head of the segment, followed by the arrays best_set, owner, attempts and queue
+struct SharedSearch::Segment {
+    pthread_mutex_t mutex;              // robust and process shared, protects the queue and the best solution set
+    std::atomic<float> best{0.0f};      // value of the best solution
+    std::atomic<uint64_t> nodes{0};     // considered nodes of the finished tasks
+    std::atomic<uint64_t> calls{0};     // oracle calls of the finished tasks
+    uint32_t size = 0;                  // items of the best solution
+    uint32_t next = 0;                  // first task that was never claimed
+    uint32_t queued = 0;                // tasks in queue
+    uint32_t requeued = 0;              // tasks put back into the queue so far
+    uint32_t finished = 0;              // tasks finished or abandoned
+    uint32_t abandoned = 0;
+};
+
+// size rounded up to a multiple of 64
+static size_t aligned(size_t bytes) {
+    return (bytes + 63) / 64 * 64;
+}
+
+SharedSearch::~SharedSearch() {
+    if (segment) {
+        munmap(segment, bytes);
+    }
+}
+
+bool SharedSearch::create(size_t tasks, size_t items) {
+    this->tasks = tasks;
+    this->items = items;
+    size_t head = aligned(sizeof(Segment));
+    size_t set = aligned(items * sizeof(int32_t));
+    size_t owners = aligned(tasks * sizeof(int32_t));
+    size_t counts = aligned(tasks * sizeof(uint8_t));
+    bytes = head + set + owners + counts + aligned(tasks * sizeof(uint32_t));
+
+    std::string name = "/skp-" + std::to_string(getpid());
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        return false;
+    }
+    shm_unlink(name.c_str()); // the segment lives as long as it is mapped, nothing is left behind if a process dies
+    if (ftruncate(fd, bytes) != 0) {
+        close(fd);
+        return false;
+    }
+    void* memory = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (memory == MAP_FAILED) {
+        return false;
+    }
+    // the segment is zero filled, the arrays start with all tasks open
+    char* base = static_cast<char*>(memory);
+    segment = new (base) Segment();
+    best_set = reinterpret_cast<int32_t*>(base + head);
+    owner = reinterpret_cast<int32_t*>(base + head + set);
+    attempts = reinterpret_cast<uint8_t*>(base + head + set + owners);
+    queue = reinterpret_cast<uint32_t*>(base + head + set + owners + counts);
+
+    pthread_mutexattr_t attributes;
+    pthread_mutexattr_init(&attributes);
+    pthread_mutexattr_setpshared(&attributes, PTHREAD_PROCESS_SHARED);
+    pthread_mutexattr_setrobust(&attributes, PTHREAD_MUTEX_ROBUST);
+    pthread_mutex_init(&segment->mutex, &attributes);
+    pthread_mutexattr_destroy(&attributes);
+    return true;
+}
+
+void SharedSearch::lock() {
+    if (pthread_mutex_lock(&segment->mutex) == EOWNERDEAD) { // a worker died while holding the lock, the data is updated in an order that stays valid
+        pthread_mutex_consistent(&segment->mutex);
+    }
+}
+
+void SharedSearch::unlock() {
+    pthread_mutex_unlock(&segment->mutex);
+}
+
+float SharedSearch::value() const {
+    return segment->best.load(std::memory_order_acquire);
+}
+
+bool SharedSearch::publish(float s_value, const std::vector<int>& S) {
+    if (s_value <= value()) { // cheap test first, most candidates are not better than the best solution
+        return false;
+    }
+    lock();
+    bool improved = s_value > segment->best.load(std::memory_order_relaxed);
+    if (improved) {
+        std::copy(S.begin(), S.end(), best_set);
+        segment->size = S.size();
+        segment->best.store(s_value, std::memory_order_release);
+    }
+    unlock();
+    return improved;
+}
+
+std::vector<int> SharedSearch::solution() {
+    lock();
+    std::vector<int> S(best_set, best_set + segment->size);
+    unlock();
+    return S;
+}
+
+long SharedSearch::claim() {
+    long task = -1;
+    lock();
+    if (segment->queued > 0) {
+        task = queue[segment->queued - 1];
+        owner[task] = getpid();
+        segment->queued--;
+    }
+    else if (segment->next < tasks) {
+        task = segment->next;
+        owner[task] = getpid(); // owner first: if the worker dies now, the task is recovered
+        segment->next++;
+    }
+    unlock();
+    return task;
+}
+
+void SharedSearch::finish(size_t task, long nodes, long oracle_calls) {
+    segment->nodes.fetch_add(nodes, std::memory_order_relaxed);
+    segment->calls.fetch_add(oracle_calls, std::memory_order_relaxed);
+    lock();
+    owner[task] = -1;
+    segment->finished++;
+    unlock();
+}
+
+void SharedSearch::recover(pid_t pid) {
+    lock();
+    for (size_t task = 0; task < tasks; ++task) {
+        if (owner[task] != pid) {
+            continue;
+        }
+        if (++attempts[task] < max_attempts) {
+            owner[task] = 0;
+            queue[segment->queued++] = task;
+            segment->requeued++;
+        }
+        else { // the task crashes every worker
+            owner[task] = -1;
+            segment->finished++;
+            segment->abandoned++;
+            std::cerr << "task " << task << " failed " << int(max_attempts) << " times and is abandoned, the result is not proven optimal" << std::endl;
+        }
+    }
+    unlock();
+}
+
+void SharedSearch::release() {
+    lock();
+    for (size_t task = 0; task < tasks; ++task) {
+        if (owner[task] > 0) {
+            owner[task] = 0;
+            queue[segment->queued++] = task;
+            segment->requeued++;
+        }
+    }
+    unlock();
+}
+
+bool SharedSearch::proven() const {
+    return segment->abandoned == 0;
+}
+
+bool SharedSearch::complete() {
+    lock();
+    bool done = segment->finished == tasks;
+    unlock();
+    return done;
+}
+
+long SharedSearch::nodes() const {
+    return segment->nodes.load();
+}
+
+long SharedSearch::oracle_calls() const {
+    return segment->calls.load();
+}
+
+size_t SharedSearch::requeued() const {
+    return segment->requeued;
+}
+
+size_t SharedSearch::abandoned() const {
+    return segment->abandoned;
+}
+
+void SharedSearch::work(Solver& solver, const std::vector<int>& order, int B) {
+    solver.shared = this;
+    long task;
+    while ((task = claim()) >= 0) {
+        // the item values are the gains at the empty set again, gains of an earlier subtree are no upper bounds in this one
+        for (size_t i = 0; i < solver.items.size(); ++i) {
+            solver.items.value[i] = solver.gaintable.single(i);
+        }
+        std::vector<int> S = {order[task]};
+        std::vector<int> C(order.begin() + task + 1, order.end());
+        long nodes = solver.counter;
+        long calls = solver.oracle_calls;
+        solver.solve(S, C, B);
+        finish(task, solver.counter - nodes, solver.oracle_calls - calls);
+    }
+}
+
+float SharedSearch::run(Solver& solver, const std::vector<int>& order, int B, unsigned workers) {
+    std::map<pid_t, unsigned> alive; // pid and number of each worker
+    std::cout.flush(); // the workers leave with _exit, buffered output is not written twice
+    auto spawn = [&](unsigned w) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            Numa::pin_worker(w);
+            work(solver, order, B);
+            _exit(0);
+        }
+        if (pid > 0) {
+            alive[pid] = w;
+        }
+        return pid > 0;
+    };
+    for (unsigned w = 0; w < workers; ++w) {
+        if (!spawn(w)) {
+            std::cerr << "cannot fork worker " << w << std::endl;
+        }
+    }
+    while (!alive.empty()) {
+        int status;
+        pid_t pid = waitpid(-1, &status, 0);
+        if (pid < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        auto it = alive.find(pid);
+        if (it == alive.end()) {
+            continue;
+        }
+        unsigned w = it->second;
+        alive.erase(it);
+        if (WIFEXITED(status) && WEXITSTATUS(status) == 0) {
+            continue;
+        }
+        // the worker died, its tasks are searched by a new worker
+        crashes++;
+        recover(pid);
+        if (!complete()) {
+            spawn(w);
+        }
+    }
+    // workers that could not be forked or were lost leave tasks behind, they are searched by this process
+    if (!complete()) {
+        release();
+        std::cerr << "the workers left tasks unfinished, they are searched by the main process" << std::endl;
+        work(solver, order, B);
+    }
+    return value();
+}
@@ -0,0 +1,90 @@
+/* This file is part of the code presented in the paper
+
+	"An Exact Solver for Submodular Knapsack Problems"
+
+by Sabine Münch and Stephen Raach
+==============================================================================*/
+
+#ifndef SharedSearch_H
+#define SharedSearch_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <sys/types.h>
+
+class Solver;
+
+// search of one instance by several processes (Linux)
+// a coordinator process forks worker processes, task k is the subtree of S = {order[k]} with the candidates order[k+1], ...
+// the search is only split at the root, a task is searched by one worker to the end, the tasks with the most candidates are claimed first
+// the tasks, the best solution and the counters live in a POSIX shared memory segment mapped by all processes,
+// the instance is loaded before the workers are forked, so its pages are shared copy-on-write and never copied
+// a worker that dies does not stop the search: the coordinator puts its tasks back into the queue and forks a new worker,
+// a task that fails 3 times is abandoned and the result is not proven optimal, tasks no worker searched are searched by the coordinator
+class SharedSearch {
+public:
+    SharedSearch() = default;
+    ~SharedSearch();
+
+    SharedSearch(const SharedSearch&) = delete;
+    SharedSearch& operator=(const SharedSearch&) = delete;
+
+    // maps a segment for the given number of tasks and solutions of up to items items, returns false if that is not possible
+    bool create(size_t tasks, size_t items);
+
+    // value of the best solution of all workers, polled in every search node
+    float value() const;
+
+    // publishes S with objective value s_value if it improves the best solution, returns true if it did
+    bool publish(float s_value, const std::vector<int>& S);
+
+    // best solution of all workers
+    std::vector<int> solution();
+
+    // coordinator: forks the workers, replaces workers that die and returns the best value when all tasks are finished
+    // worker w is pinned like the portfolio threads, each worker searches with its own copy of solver
+    // tasks left open because a worker could not be forked or was lost are searched by the coordinator itself
+    float run(Solver& solver, const std::vector<int>& order, int B, unsigned workers);
+
+    // false if a task was abandoned, the value returned by run is then the best one found but not proven optimal
+    bool proven() const;
+
+    // counters of all workers
+    long nodes() const;
+    long oracle_calls() const;
+    // workers that died, tasks put back into the queue and tasks given up
+    unsigned crashes = 0;
+    size_t requeued() const;
+    size_t abandoned() const;
+
+private:
+    struct Segment;
+    Segment* segment = nullptr;
+    size_t bytes = 0;
+    size_t tasks = 0;
+    size_t items = 0;
+    int32_t* best_set = nullptr;  // items of the best solution
+    int32_t* owner = nullptr;     // per task: 0 open, pid of the worker searching it, -1 finished
+    uint8_t* attempts = nullptr;  // per task: workers that died while searching it
+    uint32_t* queue = nullptr;    // tasks put back into the queue
+
+    // worker: next task, -1 if no task is left
+    long claim();
+    // worker: task is searched
+    void finish(size_t task, long nodes, long oracle_calls);
+    // coordinator: tasks of a dead worker are put back into the queue or abandoned
+    void recover(pid_t pid);
+    // coordinator: tasks of workers that are gone are put back into the queue, after all workers have exited
+    void release();
+    // all tasks finished or abandoned
+    bool complete();
+
+    // worker process: searches tasks until the queue is empty
+    void work(Solver& solver, const std::vector<int>& order, int B);
+
+    void lock();
+    void unlock();
+};
+
+#endif
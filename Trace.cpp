@@ -0,0 +1,80 @@
+/* This file is part of the code presented in the paper
+
+	"An Exact Solver for Submodular Knapsack Problems"
+
+by Sabine Münch and Stephen Raach
+==============================================================================*/
+
+#include "Trace.h"
+#include <cstring>
+
+Trace::~Trace() {
+    flush();
+}
+
+bool Trace::open(const std::string& path, int solver, int objective, int capacity) {
+    file.open(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        return false;
+    }
+    Header header;
+    header.solver = solver;
+    header.objective = objective;
+    header.capacity = capacity;
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    return true;
+}
+
+void Trace::write(const Record& record, const std::vector<Entry>& entries) {
+    Record r = record;
+    r.entries = entries.size();
+    const char* data = reinterpret_cast<const char*>(&r);
+    buffer.insert(buffer.end(), data, data + sizeof(r));
+    data = reinterpret_cast<const char*>(entries.data());
+    buffer.insert(buffer.end(), data, data + entries.size() * sizeof(Entry));
+    if (buffer.size() >= (1 << 20)) {
+        flush();
+    }
+}
+
+void Trace::flush() {
+    if (file.is_open() && !buffer.empty()) {
+        file.write(buffer.data(), buffer.size());
+        file.flush();
+    }
+    buffer.clear();
+}
+
+bool Trace::read(const std::string& path, Header& header, std::vector<Record>& records, std::vector<Entry>& entries, std::vector<size_t>& first) {
+    std::ifstream in(path, std::ios::binary);
+    Header expected;
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) || std::memcmp(header.magic, expected.magic, sizeof(header.magic)) != 0) {
+        return false;
+    }
+    records.clear();
+    entries.clear();
+    first.clear();
+    Record record;
+    while (in.read(reinterpret_cast<char*>(&record), sizeof(record))) {
+        first.push_back(entries.size());
+        entries.resize(entries.size() + record.entries);
+        if (!in.read(reinterpret_cast<char*>(entries.data() + first.back()), record.entries * sizeof(Entry))) {
+            return false;
+        }
+        records.push_back(record);
+    }
+    return true;
+}
+
+const char* Trace::name(Reason reason) {
+    switch (reason) {
+        case Reason::Branch: return "branch";
+        case Reason::SUB: return "SUB";
+        case Reason::EP: return "EP";
+        case Reason::Capacity: return "capacity";
+        case Reason::Leaf: return "leaf";
+        case Reason::Time: return "time";
+        case Reason::DP: return "DP";
+    }
+    return "unknown";
+}
@@ -0,0 +1,220 @@
+/* This file is part of the code presented in the paper
+
+	"An Exact Solver for Submodular Knapsack Problems"
+
+by Sabine Münch and Stephen Raach
+==============================================================================*/
+
+#ifndef Trace_H
+#define Trace_H
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+
+// binary trace of the search tree
+// file: Header, then one Record per search node followed by its Entry list, records are written in post-order (children before their parent)
+// node ids are given in pre-order, so the root has id 0 and the parent of a node has a smaller id
+class Trace {
+public:
+    // decision taken at a node
+    enum class Reason : uint8_t {
+        Branch = 0,   // node is not pruned, its children are searched
+        SUB = 1,      // pruned by the bound s_value + SUB <= s_best
+        EP = 2,       // pruned by Early Pruning (early or with the final bound of the greedy order)
+        Capacity = 3, // no capacity left or no candidate fits
+        Leaf = 4,     // no candidates
+        Time = 5,     // time limit exceeded or search stopped
+        DP = 6        // pruned by the DP bound s_value + knapsack of the current gains <= s_best
+    };
+
+    struct Header {
+        char magic[8] = {'S', 'K', 'T', 'R', 'A', 'C', 'E', '1'};
+        int32_t solver = 0;
+        int32_t objective = 0;
+        int32_t capacity = 0; // knapsack capacity B
+    };
+
+    struct Record {
+        uint32_t id = 0;
+        uint32_t parent = 0;      // id of the parent, the root is its own parent
+        uint16_t depth = 0;       // |S|
+        Reason reason = Reason::Branch;
+        uint8_t unused = 0;
+        int32_t item = -1;        // item added last to S, -1 at the root
+        int32_t capacity = 0;     // capacity left in the knapsack
+        uint32_t candidates = 0;  // |C| when the node is entered
+        uint32_t removed = 0;     // candidates removed by candidate reduction
+        float s_value = 0.0f;
+        float s_best = 0.0f;      // best value known at the decision
+        float bound = NAN;        // s_value + bound of the node, NaN if no bound is known
+        uint64_t oracle_calls = 0; // oracle calls of the node without its children
+        uint64_t nanoseconds = 0;  // time of the node without its children
+        uint32_t entries = 0;     // number of Entry following the record
+        uint32_t reserved = 0;    // fills the tail padding, the record is written as it is and contains no uninitialized bytes
+    };
+    static_assert(sizeof(Record) == 64, "Record must not contain padding");
+
+    // candidate of a node with its weight and the relative gain used for the bound, in the order of the candidate set
+    struct Entry {
+        int32_t item;
+        int32_t weight;
+        float ratio;
+    };
+
+    Trace() = default;
+    ~Trace();
+
+    Trace(const Trace&) = delete;
+    Trace& operator=(const Trace&) = delete;
+
+    // opens the trace file and writes the header, returns false if the file can not be written
+    bool open(const std::string& path, int solver, int objective, int capacity);
+    void write(const Record& record, const std::vector<Entry>& entries);
+    void flush();
+
+    // node ids in pre-order and the path of open nodes
+    std::vector<uint32_t> path;
+    uint32_t nodes = 0;
+
+    // reads a trace, entries of record k start at first[k]
+    static bool read(const std::string& path, Header& header, std::vector<Record>& records, std::vector<Entry>& entries, std::vector<size_t>& first);
+
+    static const char* name(Reason reason);
+
+private:
+    std::ofstream file;
+    std::vector<char> buffer;
+};
+
+// record of one search node, written when the node is left
+// all functions return immediately if no trace is recorded
+class TraceNode {
+public:
+    TraceNode(Trace* trace, const std::vector<int>& S, size_t candidates, const long& oracle_calls)
+        : trace(trace), oracle_calls(oracle_calls) {
+        if (!trace) {
+            return;
+        }
+        start = std::chrono::steady_clock::now();
+        calls = oracle_calls;
+        record.id = trace->nodes++;
+        record.parent = trace->path.empty() ? record.id : trace->path.back();
+        record.depth = S.size();
+        record.item = S.empty() ? -1 : S.back();
+        record.candidates = candidates;
+        trace->path.push_back(record.id);
+    }
+
+    ~TraceNode() {
+        if (!trace) {
+            return;
+        }
+        if (!stamped) {
+            stamp();
+        }
+        trace->path.pop_back();
+        trace->write(record, entries);
+    }
+
+    TraceNode(const TraceNode&) = delete;
+    TraceNode& operator=(const TraceNode&) = delete;
+
+    void value(float s_value, float s_best, int capacity) {
+        if (!trace) {
+            return;
+        }
+        record.s_value = s_value;
+        record.s_best = s_best;
+        record.capacity = capacity;
+    }
+
+    // stores the candidates in their current order with weight and relative gain gains.at(c)
+    template<typename Container, typename Map>
+    void candidates(const Container& C, const int* weight, const Map& gains) {
+        if (!trace) {
+            return;
+        }
+        entries.clear();
+        for (int c : C) {
+            entries.push_back({c, weight[c], gains.at(c)});
+        }
+    }
+
+    // stores the candidates in their current order with weight and relative gain value[c] * inv_weight[c]
+    template<typename Container>
+    void candidates(const Container& C, const int* weight, const float* value, const float* inv_weight) {
+        if (!trace) {
+            return;
+        }
+        entries.clear();
+        for (int c : C) {
+            entries.push_back({c, weight[c], value[c] * inv_weight[c]});
+        }
+    }
+
+    // the node is pruned, a missing bound is computed from the stored candidates
+    void prune(Trace::Reason reason, float s_best, float bound = NAN) {
+        if (!trace) {
+            return;
+        }
+        if (reason == Trace::Reason::SUB && entries.empty()) { // no candidate fits
+            reason = Trace::Reason::Capacity;
+        }
+        decide(reason, s_best, bound);
+    }
+
+    // the node is not pruned, removed candidates were deleted by candidate reduction
+    void branch(float s_best, float bound = NAN, size_t removed = 0) {
+        if (!trace) {
+            return;
+        }
+        record.removed = removed;
+        decide(Trace::Reason::Branch, s_best, bound);
+    }
+
+private:
+    Trace* trace;
+    const long& oracle_calls;
+    long calls = 0;
+    std::chrono::steady_clock::time_point start;
+    bool stamped = false;
+    Trace::Record record;
+    std::vector<Trace::Entry> entries;
+
+    // fractional knapsack of the stored candidates in their order
+    float packing() const {
+        int capacity = record.capacity;
+        float value = 0.0f;
+        for (const Trace::Entry& e : entries) {
+            if (e.weight <= capacity) {
+                capacity -= e.weight;
+                value += e.ratio * e.weight;
+            } else {
+                value += e.ratio * capacity;
+                break;
+            }
+        }
+        return value;
+    }
+
+    void decide(Trace::Reason reason, float s_best, float bound) {
+        record.reason = reason;
+        record.s_best = s_best;
+        record.bound = (std::isnan(bound) && !entries.empty()) ? record.s_value + packing() : bound;
+        stamp();
+    }
+
+    // time and oracle calls of the node up to its decision, the children are not included
+    void stamp() {
+        record.nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        record.oracle_calls = oracle_calls - calls;
+        stamped = true;
+    }
+};
+
+#endif
@@ -0,0 +1,144 @@
+/* This file is part of the code presented in the paper
+
+	"An Exact Solver for Submodular Knapsack Problems"
+
+by Sabine Münch and Stephen Raach
+==============================================================================*/
+
+#include "Generator.h"
+#include <vector>
+#include <random>
+#include <cmath>
+#include <fstream>
+#include <algorithm>
+#include <numeric>
+#include <filesystem>
+#include <stdexcept>
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+// uniform number in [0,1), independent of the distributions of the standard library so instances are equal on all platforms
+static double uniform(std::mt19937_64& rng) {
+    return (rng() >> 11) * 0x1.0p-53;
+}
+
+// uniform number in [low,high] rounded to three digits, as in the instances of the paper
+static double uniform(std::mt19937_64& rng, double low, double high) {
+    return std::round((low + (high - low) * uniform(rng)) * 1000.0) / 1000.0;
+}
+
+// uniform integer in [low,high]
+static int uniform(std::mt19937_64& rng, int low, int high) {
+    return low + static_cast<int>(uniform(rng) * (high - low + 1));
+}
+
+static void write(const json& data, const std::string& dir, const std::string& name) {
+    std::ofstream file(dir + "/" + name);
+    if (!file) {
+        throw std::runtime_error("cannot write " + dir + "/" + name);
+    }
+    file << data;
+}
+
+// weights of the items, mass[i] is the size of item i for correlated weights
+static std::vector<int> itemweights(const InstanceSpec& spec, const std::vector<double>& mass, std::mt19937_64& rng) {
+    std::vector<int> w(spec.n);
+    double max_mass = std::max(*std::max_element(mass.begin(), mass.end()), 1e-9);
+    for (int i = 0; i < spec.n; ++i) {
+        if (spec.weights == "equal") {
+            w[i] = spec.max_weight;
+        }
+        else if (spec.weights == "correlated") { // weight proportional to the size of the item with 10% noise
+            double noise = 0.1 * spec.max_weight * (2.0 * uniform(rng) - 1.0);
+            w[i] = std::clamp(static_cast<int>(std::lround(spec.max_weight * mass[i] / max_mass + noise)), 1, spec.max_weight);
+        }
+        else if (spec.weights == "uniform") {
+            w[i] = uniform(rng, 1, spec.max_weight);
+        }
+        else {
+            throw std::runtime_error("unknown weight distribution: " + spec.weights);
+        }
+    }
+    return w;
+}
+
+int generate(const InstanceSpec& spec, const std::string& dir) {
+    std::filesystem::create_directories(dir);
+    std::mt19937_64 rng(spec.seed);
+    std::vector<double> mass(spec.n, 0.0);
+    std::vector<int> w;
+
+    if (spec.objective == 0) { // COV: items cover random elements, every item covers at least one element
+        json items = json::array(), values = json::array();
+        for (int e = 0; e < spec.m; ++e) {
+            values.push_back(uniform(rng, 0.0, 10.0));
+        }
+        for (int i = 0; i < spec.n; ++i) {
+            json item = json::array();
+            for (int e = 0; e < spec.m; ++e) {
+                if (uniform(rng) < spec.density) {
+                    item.push_back(e);
+                    mass[i] += values[e].get<double>();
+                }
+            }
+            if (item.empty()) {
+                int e = uniform(rng, 0, spec.m - 1);
+                item.push_back(e);
+                mass[i] += values[e].get<double>();
+            }
+            items.push_back(item);
+        }
+        w = itemweights(spec, mass, rng);
+        write(items, dir, "COV_Items.json");
+        write(values, dir, "COV_Groundsetvalues.json");
+        write(w, dir, "COV_Itemsweights.json");
+    }
+    else if (spec.objective == 1) { // LOC: a location serves a customer with probability density, otherwise the benefit is 0
+        json rows = json::array();
+        for (int i = 0; i < spec.n; ++i) {
+            json row = json::array();
+            for (int j = 0; j < spec.m; ++j) {
+                double benefit = uniform(rng) < spec.density ? uniform(rng, 0.0, 10.0) : 0.0;
+                row.push_back(benefit);
+                mass[i] += benefit;
+            }
+            rows.push_back(row);
+        }
+        w = itemweights(spec, mass, rng);
+        write(rows, dir, "LOC_benefits.json");
+        write(w, dir, "LOC_weights.json");
+    }
+    else if (spec.objective == 2) { // INF: random bipartite graph with edge probability density
+        json connections = json::array(), probability = json::array();
+        for (int i = 0; i < spec.n; ++i) {
+            probability.push_back(uniform(rng, 0.05, 0.6));
+        }
+        for (int i = 0; i < spec.n; ++i) {
+            json row = json::array();
+            for (int j = 0; j < spec.m; ++j) {
+                int edge = uniform(rng) < spec.density ? 1 : 0;
+                row.push_back(edge);
+                mass[i] += edge * probability[i].get<double>();
+            }
+            connections.push_back(row);
+        }
+        w = itemweights(spec, mass, rng);
+        write(connections, dir, "INF_connections.json");
+        write(probability, dir, "INF_probability.json");
+        write(w, dir, "INF_weights.json");
+    }
+    else {
+        throw std::runtime_error("unknown objective function: " + std::to_string(spec.objective));
+    }
+
+    long total = std::accumulate(w.begin(), w.end(), 0L);
+    return std::max(1, static_cast<int>(std::lround(spec.tightness * total)));
+}
+
+int objective(const std::string& name) {
+    if (name == "0" || name == "cov" || name == "COV") return 0;
+    if (name == "1" || name == "loc" || name == "LOC") return 1;
+    if (name == "2" || name == "inf" || name == "INF") return 2;
+    return -1;
+}
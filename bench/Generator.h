@@ -0,0 +1,33 @@
+/* This file is part of the code presented in the paper
+
+	"An Exact Solver for Submodular Knapsack Problems"
+
+by Sabine Münch and Stephen Raach
+==============================================================================*/
+
+#ifndef Generator_H
+#define Generator_H
+
+#include <string>
+#include <cstdint>
+
+// parameters of a synthetic instance
+struct InstanceSpec {
+    int objective = 0;       // 0 COV, 1 LOC, 2 INF
+    int n = 30;              // items (sets, locations, sources)
+    int m = 60;              // ground set elements, customers or targets
+    double density = 0.1;    // probability that an item covers an element, serves a customer or reaches a target
+    std::string weights = "uniform"; // uniform, correlated or equal
+    int max_weight = 20;     // weights are integers in 1, ..., max_weight
+    double tightness = 0.1;  // knapsack capacity as fraction of the total weight
+    uint64_t seed = 1;
+};
+
+// writes the json files of the instance in the format of Load.cpp into dir
+// Output: knapsack capacity B = tightness * total weight, at least 1
+int generate(const InstanceSpec& spec, const std::string& dir);
+
+// parses the objective from its number or name (cov, loc, inf), -1 if unknown
+int objective(const std::string& name);
+
+#endif
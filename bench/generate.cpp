@@ -0,0 +1,70 @@
+/* This file is part of the code presented in the paper
+
+	"An Exact Solver for Submodular Knapsack Problems"
+
+by Sabine Münch and Stephen Raach
+==============================================================================*/
+
+#include <iostream>
+#include <string>
+#include <exception>
+#include "Generator.h"
+
+// writes one synthetic instance, the knapsack capacity for the given tightness is printed
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " <directory> <cov|loc|inf> [--n n] [--m m] [--density d] [--weights uniform|correlated|equal] [--max-weight w] [--tightness t] [--seed s]" << std::endl;
+        return 1;
+    }
+
+    InstanceSpec spec;
+    std::string dir = argv[1];
+    spec.objective = objective(argv[2]);
+    if (spec.objective < 0) {
+        std::cerr << "unknown objective function: " << argv[2] << std::endl;
+        return 1;
+    }
+    for (int a = 3; a < argc; ++a) {
+        std::string option = argv[a];
+        if (a + 1 >= argc) {
+            std::cerr << "missing value: " << option << std::endl;
+            return 1;
+        }
+        std::string value = argv[++a];
+        if (option == "--n") {
+            spec.n = std::stoi(value);
+        }
+        else if (option == "--m") {
+            spec.m = std::stoi(value);
+        }
+        else if (option == "--density") {
+            spec.density = std::stod(value);
+        }
+        else if (option == "--weights") {
+            spec.weights = value;
+        }
+        else if (option == "--max-weight") {
+            spec.max_weight = std::stoi(value);
+        }
+        else if (option == "--tightness") {
+            spec.tightness = std::stod(value);
+        }
+        else if (option == "--seed") {
+            spec.seed = std::stoull(value);
+        }
+        else {
+            std::cerr << "unknown option: " << option << std::endl;
+            return 1;
+        }
+    }
+
+    try {
+        int B = generate(spec, dir);
+        std::cout << "knapsack capacity: " << B << std::endl;
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
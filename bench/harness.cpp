@@ -0,0 +1,396 @@
+/* This file is part of the code presented in the paper
+
+	"An Exact Solver for Submodular Knapsack Problems"
+
+by Sabine Münch and Stephen Raach
+==============================================================================*/
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <exception>
+#include <unistd.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+#include <nlohmann/json.hpp>
+#include "Generator.h"
+
+using json = nlohmann::json;
+
+// one line of the suite file
+struct Instance {
+    std::string name;
+    InstanceSpec spec;
+    int B = 0;
+};
+
+// result of one run of the solver
+struct Run {
+    std::string instance;
+    int objective = 0;
+    int n = 0;
+    int m = 0;
+    int B = 0;
+    int solver = 0;
+    std::string status;  // ok, timeout or failed
+    double value = 0.0;
+    double runtime = 0.0;
+    long nodes = 0;
+    long oracle_calls = 0;
+    long peak_rss = 0;   // peak resident set size of the process in KB
+};
+
+// suite file: one instance per line "name objective n m density weights tightness seed", # starts a comment
+static std::vector<Instance> readsuite(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        throw std::runtime_error("cannot read suite " + path);
+    }
+    std::vector<Instance> suite;
+    std::string line;
+    while (std::getline(file, line)) {
+        line = line.substr(0, line.find('#'));
+        std::stringstream stream(line);
+        Instance instance;
+        std::string objective_name;
+        if (!(stream >> instance.name)) { // empty line
+            continue;
+        }
+        InstanceSpec& spec = instance.spec;
+        if (!(stream >> objective_name >> spec.n >> spec.m >> spec.density >> spec.weights >> spec.tightness >> spec.seed)) {
+            throw std::runtime_error("malformed suite line: " + line);
+        }
+        spec.objective = objective(objective_name);
+        if (spec.objective < 0) {
+            throw std::runtime_error("unknown objective function: " + objective_name);
+        }
+        suite.push_back(instance);
+    }
+    return suite;
+}
+
+// token following key in the output of main, empty if key is missing
+static std::string field(const std::string& output, const std::string& key) {
+    size_t position = output.find(key);
+    if (position == std::string::npos) {
+        return "";
+    }
+    std::stringstream stream(output.substr(position + key.size()));
+    std::string token;
+    stream >> token;
+    return token;
+}
+
+// runs main in the directory of the instance, peak memory is taken from the resource usage of the child
+static void execute(const std::string& main, const std::string& dir, const std::vector<std::string>& args, unsigned timeout, Run& run) {
+    int channel[2];
+    if (pipe(channel) != 0) {
+        throw std::runtime_error("pipe failed");
+    }
+    pid_t pid = fork();
+    if (pid < 0) {
+        throw std::runtime_error("fork failed");
+    }
+    if (pid == 0) { // child: stdout into the pipe, killed by SIGALRM after the timeout
+        dup2(channel[1], STDOUT_FILENO);
+        close(channel[0]);
+        close(channel[1]);
+        if (chdir(dir.c_str()) != 0) {
+            _exit(127);
+        }
+        std::vector<char*> argv;
+        argv.push_back(const_cast<char*>(main.c_str()));
+        for (const std::string& arg : args) {
+            argv.push_back(const_cast<char*>(arg.c_str()));
+        }
+        argv.push_back(nullptr);
+        alarm(timeout);
+        execv(main.c_str(), argv.data());
+        _exit(127);
+    }
+    close(channel[1]);
+    std::string output;
+    char buffer[4096];
+    ssize_t length;
+    while ((length = read(channel[0], buffer, sizeof(buffer))) > 0) {
+        output.append(buffer, length);
+    }
+    close(channel[0]);
+
+    int status = 0;
+    struct rusage usage;
+    wait4(pid, &status, 0, &usage);
+    run.peak_rss = usage.ru_maxrss;
+    if (WIFSIGNALED(status) && WTERMSIG(status) == SIGALRM) {
+        run.status = "timeout";
+        return;
+    }
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0 || field(output, "optimal solution value: ").empty()) {
+        run.status = "failed";
+        return;
+    }
+    run.status = "ok";
+    run.value = std::stod(field(output, "optimal solution value: "));
+    run.runtime = std::stod(field(output, "running time: "));
+    run.nodes = std::stol(field(output, "considered nodes: "));
+    std::string calls = field(output, "oracle calls: "); // missing in the output of older versions of main
+    run.oracle_calls = calls.empty() ? 0 : std::stol(calls);
+}
+
+static const char* header = "instance,objective,n,m,B,solver,status,value,runtime,nodes,oracle_calls,peak_rss_kb";
+
+static void writecsv(const std::vector<Run>& runs, const std::string& path) {
+    std::ofstream file(path);
+    file << header << "\n" << std::setprecision(9);
+    for (const Run& r : runs) {
+        file << r.instance << "," << r.objective << "," << r.n << "," << r.m << "," << r.B << "," << r.solver << "," << r.status << ","
+             << r.value << "," << r.runtime << "," << r.nodes << "," << r.oracle_calls << "," << r.peak_rss << "\n";
+    }
+}
+
+static void writejson(const std::vector<Run>& runs, const std::string& path) {
+    json results = json::array();
+    for (const Run& r : runs) {
+        results.push_back({{"instance", r.instance}, {"objective", r.objective}, {"n", r.n}, {"m", r.m}, {"B", r.B}, {"solver", r.solver},
+                           {"status", r.status}, {"value", r.value}, {"runtime", r.runtime}, {"nodes", r.nodes},
+                           {"oracle_calls", r.oracle_calls}, {"peak_rss_kb", r.peak_rss}});
+    }
+    std::ofstream(path) << results.dump(2) << std::endl;
+}
+
+// runs of a csv file written by writecsv, indexed by instance and solver
+static std::map<std::pair<std::string, int>, Run> readcsv(const std::string& path) {
+    std::map<std::pair<std::string, int>, Run> runs;
+    std::ifstream file(path);
+    if (!file) {
+        throw std::runtime_error("cannot read baseline " + path);
+    }
+    std::string line;
+    std::getline(file, line); // header
+    while (std::getline(file, line)) {
+        std::vector<std::string> cells;
+        std::stringstream stream(line);
+        std::string cell;
+        while (std::getline(stream, cell, ',')) {
+            cells.push_back(cell);
+        }
+        if (cells.size() != 12) {
+            continue;
+        }
+        Run r;
+        r.instance = cells[0];
+        r.objective = std::stoi(cells[1]);
+        r.n = std::stoi(cells[2]);
+        r.m = std::stoi(cells[3]);
+        r.B = std::stoi(cells[4]);
+        r.solver = std::stoi(cells[5]);
+        r.status = cells[6];
+        r.value = std::stod(cells[7]);
+        r.runtime = std::stod(cells[8]);
+        r.nodes = std::stol(cells[9]);
+        r.oracle_calls = std::stol(cells[10]);
+        r.peak_rss = std::stol(cells[11]);
+        runs[{r.instance, r.solver}] = r;
+    }
+    return runs;
+}
+
+// compares the runs with the baseline, returns false if a deterministic column (value, nodes, oracle calls) or the status of a run differs
+// runtimes differ between machines and from run to run: they are compared only as the geometric mean of the runtime ratios over the suite,
+// this mean fails the comparison only if a tolerance is given (the baseline should then be recorded on the same machine), otherwise it is reported
+// runtimes below the noise floor are not included in the mean
+static bool compare(const std::vector<Run>& runs, const std::map<std::pair<std::string, int>, Run>& baseline, double tolerance) {
+    const double noise = 0.05;
+    bool passed = true;
+    double log_time = 0.0, log_nodes = 0.0;
+    int timed = 0, counted = 0;
+    std::cout << "\ncomparison with baseline (ratio = run / baseline)" << std::endl;
+    for (const Run& r : runs) {
+        auto it = baseline.find({r.instance, r.solver});
+        if (it == baseline.end()) {
+            std::cout << r.instance << " y=" << r.solver << ": not in baseline" << std::endl;
+            continue;
+        }
+        const Run& b = it->second;
+        std::string verdict;
+        if (r.status != "ok" || b.status != "ok") {
+            verdict = (r.status == b.status) ? "" : "status " + b.status + " -> " + r.status;
+            passed = passed && (r.status == "ok" || b.status != "ok");
+        }
+        else {
+            double time_ratio = r.runtime / std::max(b.runtime, 1e-9);
+            double node_ratio = static_cast<double>(std::max(r.nodes, 1L)) / std::max(b.nodes, 1L);
+            log_nodes += std::log(node_ratio);
+            counted++;
+            if (std::fabs(r.value - b.value) > 1e-4 * std::max(1.0, std::fabs(b.value))) {
+                verdict = "VALUE " + std::to_string(b.value) + " -> " + std::to_string(r.value);
+                passed = false;
+            }
+            else if (r.nodes != b.nodes) {
+                verdict = "NODES " + std::to_string(b.nodes) + " -> " + std::to_string(r.nodes);
+                passed = false;
+            }
+            else if (r.oracle_calls != b.oracle_calls) {
+                verdict = "ORACLE CALLS " + std::to_string(b.oracle_calls) + " -> " + std::to_string(r.oracle_calls);
+                passed = false;
+            }
+            if (b.runtime >= noise || r.runtime >= noise) {
+                log_time += std::log(time_ratio);
+                timed++;
+            }
+            std::cout << r.instance << " y=" << r.solver << std::fixed << std::setprecision(3)
+                      << ": time " << time_ratio << " nodes " << node_ratio
+                      << " oracle calls " << static_cast<double>(std::max(r.oracle_calls, 1L)) / std::max(b.oracle_calls, 1L)
+                      << " rss " << static_cast<double>(r.peak_rss) / std::max(b.peak_rss, 1L) << std::defaultfloat;
+        }
+        if (!verdict.empty()) {
+            std::cout << " " << verdict;
+        }
+        std::cout << std::endl;
+    }
+    if (timed > 0) {
+        double mean = std::exp(log_time / timed);
+        std::cout << "geometric mean of runtime ratios: " << mean;
+        if (tolerance > 0.0 && mean > 1.0 + tolerance) {
+            std::cout << " SLOWER";
+            passed = false;
+        }
+        else if (tolerance <= 0.0) {
+            std::cout << " (not checked, pass --tolerance r to fail above 1+r)";
+        }
+        std::cout << std::endl;
+    }
+    if (counted > 0) {
+        std::cout << "geometric mean of node ratios: " << std::exp(log_nodes / counted) << std::endl;
+    }
+    std::cout << (passed ? "baseline passed" : "baseline FAILED") << std::endl;
+    return passed;
+}
+
+// runs a case repeat times, runtime and peak memory are the medians of the runs, the deterministic columns are those of the first run
+// a run that fails or times out decides the status
+static void measure(const std::string& main, const std::string& dir, const std::vector<std::string>& args, unsigned timeout, unsigned repeat, Run& run) {
+    std::vector<double> runtimes;
+    std::vector<long> peaks;
+    for (unsigned k = 0; k < repeat; ++k) {
+        Run attempt = run;
+        execute(main, dir, args, timeout, attempt);
+        if (attempt.status != "ok") {
+            run.status = attempt.status;
+            run.peak_rss = attempt.peak_rss;
+            return;
+        }
+        if (k == 0) {
+            run = attempt;
+        }
+        runtimes.push_back(attempt.runtime);
+        peaks.push_back(attempt.peak_rss);
+    }
+    std::sort(runtimes.begin(), runtimes.end());
+    std::sort(peaks.begin(), peaks.end());
+    run.runtime = runtimes[runtimes.size() / 2];
+    run.peak_rss = peaks[peaks.size() / 2];
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <suite> [--main path] [--solvers list] [--instances dir] [--out prefix] [--baseline csv] [--tolerance r] [--repeat k] [--timeout s] [--args \"options of main\"]" << std::endl;
+        return 1;
+    }
+
+    std::string suite_path = argv[1];
+    std::string main_path = "./main";
+    std::string solvers = "0,1,2,3,4,5,6,7,8";
+    std::string instances = "bench/instances";
+    std::string out = "bench/results";
+    std::string baseline_path;
+    double tolerance = 0.0;    // allowed slowdown of the geometric mean of the runtimes against the baseline, 0 only reports it
+    unsigned repeat = 5;       // runs per case, the median runtime is reported
+    unsigned timeout = 600;    // seconds per run
+    std::vector<std::string> extra;
+    for (int a = 2; a < argc; ++a) {
+        std::string option = argv[a];
+        if (a + 1 >= argc) {
+            std::cerr << "missing value: " << option << std::endl;
+            return 1;
+        }
+        std::string value = argv[++a];
+        if (option == "--main") main_path = value;
+        else if (option == "--solvers") solvers = value;
+        else if (option == "--instances") instances = value;
+        else if (option == "--out") out = value;
+        else if (option == "--baseline") baseline_path = value;
+        else if (option == "--tolerance") tolerance = std::stod(value);
+        else if (option == "--repeat") repeat = std::max(1ul, std::stoul(value));
+        else if (option == "--timeout") timeout = std::stoul(value);
+        else if (option == "--args") {
+            std::stringstream stream(value);
+            std::string arg;
+            while (stream >> arg) {
+                extra.push_back(arg);
+            }
+        }
+        else {
+            std::cerr << "unknown option: " << option << std::endl;
+            return 1;
+        }
+    }
+
+    try {
+        main_path = std::filesystem::absolute(main_path).string(); // main runs in the directory of the instance
+        std::vector<Instance> suite = readsuite(suite_path);
+        std::vector<int> solver_types;
+        std::stringstream stream(solvers);
+        std::string type;
+        while (std::getline(stream, type, ',')) {
+            solver_types.push_back(std::stoi(type));
+        }
+
+        // generate all instances first, so the runs are not disturbed by writing files
+        for (Instance& instance : suite) {
+            instance.B = generate(instance.spec, instances + "/" + instance.name);
+        }
+
+        std::vector<Run> runs;
+        std::cout << std::left << std::setw(16) << "instance" << std::setw(6) << "B" << std::setw(4) << "y" << std::setw(9) << "status"
+                  << std::setw(14) << "value" << std::setw(12) << "runtime" << std::setw(12) << "nodes" << std::setw(14) << "oracle calls" << "peak rss KB" << std::endl;
+        for (const Instance& instance : suite) {
+            for (int y : solver_types) {
+                Run run;
+                run.instance = instance.name;
+                run.objective = instance.spec.objective;
+                run.n = instance.spec.n;
+                run.m = instance.spec.m;
+                run.B = instance.B;
+                run.solver = y;
+                std::vector<std::string> args = {std::to_string(instance.B), std::to_string(run.objective), std::to_string(y)};
+                args.insert(args.end(), extra.begin(), extra.end());
+                measure(main_path, instances + "/" + instance.name, args, timeout, repeat, run);
+                runs.push_back(run);
+                std::cout << std::setw(16) << run.instance << std::setw(6) << run.B << std::setw(4) << y << std::setw(9) << run.status
+                          << std::setw(14) << run.value << std::setw(12) << run.runtime << std::setw(12) << run.nodes << std::setw(14) << run.oracle_calls << run.peak_rss << std::endl;
+            }
+        }
+
+        writecsv(runs, out + ".csv");
+        writejson(runs, out + ".json");
+        std::cout << "results written to " << out << ".csv and " << out << ".json" << std::endl;
+
+        if (!baseline_path.empty()) {
+            return compare(runs, readcsv(baseline_path), tolerance) ? 0 : 1;
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,424 @@
+/* This file is part of the code presented in the paper
+
+	"An Exact Solver for Submodular Knapsack Problems"
+
+by Sabine Münch and Stephen Raach
+==============================================================================*/
+
+// microbenchmarks of the oracles and of the bound kernels of the solvers
+// every kernel is called repeatedly on one fixed search node of a generated instance, the node has a set S of a few greedy items
+// reported per call: time, estimated bytes of instance and candidate data read, heap allocations and arena allocations
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <new>
+#include <filesystem>
+#include <exception>
+#include "../functions.h"
+#include "../objectivefunctions.h"
+#include "../Load.h"
+#include "../PackingTree.h"
+#include "../COVEngine.h"
+#include "../LOCEngine.h"
+#include "../INFEngine.h"
+#include "Generator.h"
+
+// heap allocations of the process, counted by the replaced operator new
+static size_t heap_allocations = 0;
+
+void* operator new(size_t size) {
+    heap_allocations++;
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new(size_t size, std::align_val_t alignment) {
+    heap_allocations++;
+    size_t a = static_cast<size_t>(alignment);
+    if (void* p = std::aligned_alloc(a, (size + a - 1) / a * a)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { std::free(p); }
+
+// results are written here, so the compiler can not drop the kernels
+static volatile float sink;
+
+// solver that only provides the kernels
+struct Kernels : Solver {
+    float solve(std::vector<int>&, const std::vector<int>&, int) override { return 0.0f; }
+};
+
+// one objective with its instance, its engine and a search node
+struct Fixture {
+    std::string name;
+    std::function<float(const std::vector<int>&)> f;
+    std::function<float(int)> single;
+    std::shared_ptr<ObjectiveEngine> engine;
+    Kernels solver;
+
+    // evaluations counted by the hooks of the solver
+    size_t f_calls = 0;
+    size_t gain_items = 0;
+
+    // estimated bytes read by one call of f on S+c and by the marginal gain of one item
+    double f_bytes = 0.0;
+    double gain_bytes = 0.0;
+
+    // search node: set S, parent set S minus the last item
+    std::vector<int> S;
+    float s_value = 0.0f;
+    float s_best = 0.0f;
+    int capacity = 0;
+    Candidates C{std::pmr::new_delete_resource()};        // candidates of S in the order of the parent (input of LE and EP)
+    Gains previous_gains{std::pmr::new_delete_resource()}; // relative gains at the parent
+    Candidates sorted{std::pmr::new_delete_resource()};   // candidates of S in greedy order at S
+    Gains current_gains{std::pmr::new_delete_resource()};  // relative gains at S
+    size_t split = 0;     // items packed by SUB_CR
+    size_t split_le = 0;  // items packed by SUB_LECR
+    std::vector<std::vector<int>> extended; // S+c for the candidates c
+};
+
+struct Result {
+    double ns = 0.0;
+    double bytes = 0.0;
+    double heap = 0.0;
+    double arena = 0.0;
+};
+
+// calls run in batches of doubling size until min_seconds have passed
+// bytes(calls) estimates the bytes read by all calls, it may use the evaluations counted by the hooks
+template<typename Run, typename Bytes>
+static Result measure(Fixture& x, double min_seconds, Run run, Bytes bytes) {
+    run(); // warm up caches and the state of the engine
+    x.f_calls = x.gain_items = 0;
+    size_t heap = heap_allocations;
+    size_t arena = x.solver.arena.allocations;
+    size_t calls = 0;
+    double elapsed = 0.0;
+    for (size_t batch = 1; elapsed < min_seconds; batch *= 2) {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t k = 0; k < batch; ++k) {
+            run();
+        }
+        elapsed += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        calls += batch;
+    }
+    Result r;
+    r.ns = elapsed * 1e9 / calls;
+    r.bytes = bytes(calls) / calls;
+    r.heap = static_cast<double>(heap_allocations - heap) / calls;
+    r.arena = static_cast<double>(x.solver.arena.allocations - arena) / calls;
+    return r;
+}
+
+static void print(const Fixture& x, const std::string& kernel, const Result& r) {
+    std::cout << std::left << std::setw(6) << x.name << std::setw(18) << kernel << std::right << std::fixed
+              << std::setprecision(1) << std::setw(14) << r.ns << std::setw(14) << r.bytes
+              << std::setprecision(2) << std::setw(10) << r.bytes / r.ns
+              << std::setw(10) << r.heap << std::setw(10) << r.arena << std::defaultfloat << std::endl;
+}
+
+// number of adjacent elements or targets of item v
+static int degree(const std::vector<int>& first, int v) {
+    return first[v + 1] - first[v];
+}
+
+// estimated bytes read by f on the set X
+static double fbytes(int objective, const std::vector<int>& X) {
+    double total = 0.0;
+    if (objective == 0) { // element indices and values of the adjacency, bit vector of covered elements
+        for (int v : X) total += 8.0 * degree(first_element, v);
+        total += values.size() / 8.0;
+    }
+    else if (objective == 1) { // benefit rows and the maxima of the customers
+        total = 4.0 * (X.size() + 1) * benefits[0].size();
+    }
+    else { // target indices and survival probabilities of the adjacency, written and summed vector of probabilities
+        for (int v : X) total += 8.0 * degree(first_target, v);
+        total += 8.0 * m;
+    }
+    return total;
+}
+
+// estimated bytes read for the marginal gain of c by the engine
+static double gainbytes(int objective, int c) {
+    if (objective == 0) return 12.0 * degree(first_element, c); // element, counter and value
+    if (objective == 1) return 8.0 * benefits[0].size();          // benefit row and maxima
+    return 8.0 * degree(first_target, c);                         // target and survival probability
+}
+
+// loads the instance of the objective, builds its engine and the search node
+static void setup(Fixture& x, int objective, const std::string& dir, int depth) {
+    auto cwd = std::filesystem::current_path();
+    std::filesystem::current_path(dir);
+    if (objective == 0) {
+        x.name = "COV";
+        x.f = f1;
+        x.single = f1_single;
+        loadData_f1();
+        x.engine = std::make_shared<COVEngine>();
+    }
+    else if (objective == 1) {
+        x.name = "LOC";
+        x.f = f2;
+        x.single = f2_single;
+        loadData_f2();
+        x.engine = std::make_shared<LOCEngine>(LOCEngine::Storage::Float);
+    }
+    else {
+        x.name = "INF";
+        x.f = f3;
+        x.single = f3_single;
+        loadData_f3();
+        x.engine = std::make_shared<INFEngine>();
+    }
+    std::filesystem::current_path(cwd);
+
+    Solver& solver = x.solver;
+    x.solver.gaintable.build(x.f, x.single, weights, 0, 1);
+    for (size_t i = 0; i < weights.size(); ++i) {
+        solver.items.push_back(weights[i], solver.gaintable.single(i));
+    }
+    solver.f = [&x](const std::vector<int>& X) { x.f_calls++; return x.f(X); };
+    solver.gain = [&x](const std::vector<int>& X, int c) { x.gain_items++; return x.engine->gain(X, c); };
+    solver.gains = [&x](const std::vector<int>& X, const int* C, size_t n, float* out) { x.gain_items += n; x.engine->gains(X, C, n, out); };
+
+    // S: the first items of the greedy order by relative singleton value, capacity for about a tenth of the remaining items
+    std::vector<int> order(weights.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::sort(order.begin(), order.end(), [&](int a, int b) {
+        return solver.items.value[a] * solver.items.inv_weight[a] > solver.items.value[b] * solver.items.inv_weight[b];
+    });
+    long total = 0;
+    for (int w : weights) total += w;
+    x.S.assign(order.begin(), order.begin() + depth);
+    x.capacity = std::max(1L, total / 10);
+
+    // parent node: greedy order and relative gains at S minus its last item
+    std::vector<int> parent(x.S.begin(), x.S.end() - 1);
+    Candidates all(std::pmr::new_delete_resource());
+    for (size_t i = depth; i < order.size(); ++i) all.push_back(order[i]);
+    all.push_back(x.S.back());
+    {
+        ArenaScope scope(solver.arena);
+        auto [parent_sorted, parent_split] = solver.DCO(parent, all, x.f(parent), x.capacity + weights[x.S.back()]);
+        solver.order(parent_sorted, parent_split);
+        for (int c : parent_sorted) {
+            x.previous_gains[c] = solver.items.value[c] * solver.items.inv_weight[c];
+            if (c != x.S.back() && weights[c] <= x.capacity) {
+                x.C.push_back(c);
+            }
+        }
+    }
+
+    // node S: greedy order, gains and packed items, the best value lets CR remove a part of the candidates
+    x.s_value = x.f(x.S);
+    {
+        ArenaScope scope(solver.arena);
+        auto [sorted, sorted_split] = solver.DCO(x.S, x.C, x.s_value, x.capacity);
+        solver.order(sorted, sorted_split);
+        x.sorted.assign(sorted.begin(), sorted.end());
+    }
+    for (int c : x.sorted) {
+        x.current_gains[c] = solver.items.value[c] * solver.items.inv_weight[c];
+    }
+    x.split = solver.SUB_CR(x.sorted, x.capacity).second;
+    x.split_le = solver.SUB_LECR(x.sorted, x.capacity, x.current_gains).second;
+    x.s_best = x.s_value + 0.9f * solver.SUB(x.sorted, x.capacity);
+
+    for (int c : x.C) {
+        x.extended.push_back(x.S);
+        x.extended.back().push_back(c);
+        x.f_bytes += fbytes(objective, x.extended.back());
+        x.gain_bytes += gainbytes(objective, c);
+    }
+    x.f_bytes /= x.C.size();
+    x.gain_bytes /= x.C.size();
+}
+
+static void run(Fixture& x, double seconds, const std::string& filter) {
+    Solver& solver = x.solver;
+    const double n = x.C.size();
+    const double items = 12.0; // bytes of weight, value and candidate entry of an item
+    const double hashed = 16.0; // bytes of a lookup in Gains
+    double logn = std::log2(std::max(2.0, n));
+
+    auto oracle = [&](size_t) { return x.f_calls * x.f_bytes + x.gain_items * x.gain_bytes; };
+    auto bench = [&](const std::string& kernel, auto kernel_run, auto bytes) {
+        if (kernel.find(filter) == std::string::npos) {
+            return;
+        }
+        print(x, kernel, measure(x, seconds, kernel_run, bytes));
+    };
+
+    size_t i = 0;
+    bench("f", [&]() {
+        sink = x.f(x.extended[i++ % x.extended.size()]);
+    }, [&](size_t calls) { return calls * x.f_bytes; });
+
+    auto gain = solver.gain;
+    auto gains = solver.gains;
+    solver.gain = nullptr;
+    solver.gains = nullptr;
+    bench("z (f)", [&]() {
+        sink = solver.z(x.S, x.C[i++ % x.C.size()], x.s_value);
+    }, [&](size_t calls) { return oracle(calls) + calls * 4.0 * (x.S.size() + 1); });
+    solver.gain = gain;
+    solver.gains = gains;
+
+    bench("z (engine)", [&]() {
+        sink = solver.z(x.S, x.C[i++ % x.C.size()], x.s_value);
+    }, oracle);
+
+    std::vector<float> out(x.C.size());
+    bench("zbatch", [&]() {
+        solver.zbatch(x.S, x.C.data(), x.C.size(), x.s_value, out.data());
+        sink = out[0];
+    }, oracle);
+
+    bench("DCO", [&]() {
+        ArenaScope scope(solver.arena);
+        auto result = solver.DCO(x.S, x.C, x.s_value, x.capacity);
+        sink = result.second;
+    }, [&](size_t calls) { return oracle(calls) + calls * n * (items + 24.0); });
+
+    bench("SUB", [&]() {
+        sink = solver.SUB(x.sorted, x.capacity);
+    }, [&](size_t calls) { return calls * (x.split + 1) * items; });
+
+    bench("SUB_CR", [&]() {
+        sink = solver.SUB_CR(x.sorted, x.capacity).first;
+    }, [&](size_t calls) { return calls * (x.split + 1) * items; });
+
+    bench("SUB_LECR", [&]() {
+        sink = solver.SUB_LECR(x.sorted, x.capacity, x.current_gains).first;
+    }, [&](size_t calls) { return calls * (x.split_le + 1) * (8.0 + hashed); });
+
+    solver.dp_cells = static_cast<size_t>(-1);
+    bench("DP", [&]() {
+        ArenaScope scope(solver.arena);
+        sink = solver.knapsack(x.sorted, x.capacity, &x.current_gains).at(0, x.capacity);
+    }, [&](size_t calls) { return calls * n * (x.capacity + 1) * 12.0; }); // two rows read and one row written per item
+    solver.dp_cells = 0;
+
+    PackingTree tree(std::pmr::new_delete_resource());
+    for (int c : x.sorted) {
+        tree.insert(c, x.current_gains.at(c), weights[c]);
+    }
+    bench("track", [&]() {
+        sink = tree.track(x.capacity).first;
+    }, [&](size_t calls) { return calls * 2.0 * logn * 40.0; }); // two nodes per level of the treap
+
+    bench("LE", [&]() {
+        ArenaScope scope(solver.arena);
+        auto result = solver.LE(x.S, x.C, x.s_value, x.s_best, x.capacity, &x.previous_gains);
+        sink = std::get<2>(result);
+    }, [&](size_t calls) { return oracle(calls) + calls * n * (items + 2.0 * hashed + 12.0); });
+
+    bench("EP", [&]() {
+        ArenaScope scope(solver.arena);
+        auto result = solver.EP(x.S, x.C, x.s_value, x.s_best, x.capacity, &x.previous_gains);
+        sink = std::get<0>(result);
+    }, [&](size_t calls) { return oracle(calls) + calls * n * (items + 2.0 * hashed + 40.0 * logn); });
+
+    // the candidate reductions change their input, each call works on a copy of the sorted candidates (included in the time)
+    auto reduction = [&](size_t split, double per_item) {
+        return [&, split, per_item](size_t calls) {
+            return calls * (8.0 * n + split * per_item + (n - split) * (4.0 * logn + per_item));
+        };
+    };
+    bench("CR", [&]() {
+        ArenaScope scope(solver.arena);
+        Candidates C(x.sorted.begin(), x.sorted.end(), &solver.arena);
+        solver.CR(C, x.s_value, x.split, x.s_best, x.capacity);
+        sink = C.size();
+    }, reduction(x.split, items));
+
+    bench("CR_LE", [&]() {
+        ArenaScope scope(solver.arena);
+        Candidates C(x.sorted.begin(), x.sorted.end(), &solver.arena);
+        solver.CR_LE(C, x.s_value, x.split_le, x.s_best, x.capacity, x.current_gains);
+        sink = C.size();
+    }, reduction(x.split_le, 8.0 + hashed));
+
+    size_t split_ep = solver.packedsplit(x.sorted, x.capacity);
+    bench("CRep", [&]() {
+        ArenaScope scope(solver.arena);
+        Candidates C(x.sorted.begin(), x.sorted.end(), &solver.arena);
+        solver.CRep(C, x.s_value, split_ep, x.s_best, x.capacity, x.current_gains);
+        sink = C.size();
+    }, reduction(split_ep, 8.0 + hashed));
+}
+
+int main(int argc, char* argv[]) {
+    InstanceSpec spec;
+    spec.n = 200;
+    spec.m = 1000;
+    spec.seed = 1;
+    int depth = 5;          // items in S
+    double seconds = 0.2;   // minimal measured time per kernel
+    std::string filter;     // only kernels whose name contains filter
+    std::string objectives = "cov,loc,inf";
+    std::string instances = "bench/instances";
+    for (int a = 1; a < argc; ++a) {
+        std::string option = argv[a];
+        if (a + 1 >= argc) {
+            std::cerr << "Usage: " << argv[0] << " [--n n] [--m m] [--depth d] [--seed s] [--time seconds] [--objectives cov,loc,inf] [--filter kernel] [--instances dir]" << std::endl;
+            return 1;
+        }
+        std::string value = argv[++a];
+        if (option == "--n") spec.n = std::stoi(value);
+        else if (option == "--m") spec.m = std::stoi(value);
+        else if (option == "--depth") depth = std::stoi(value);
+        else if (option == "--seed") spec.seed = std::stoull(value);
+        else if (option == "--time") seconds = std::stod(value);
+        else if (option == "--objectives") objectives = value;
+        else if (option == "--filter") filter = value;
+        else if (option == "--instances") instances = value;
+        else {
+            std::cerr << "unknown option: " << option << std::endl;
+            return 1;
+        }
+    }
+    depth = std::max(1, std::min(depth, spec.n - 1));
+
+    // densities give adjacencies and benefit rows of realistic shape
+    const double density[3] = {0.02, 0.3, 0.02};
+    const char* names[3] = {"cov", "loc", "inf"};
+
+    std::cout << std::left << std::setw(6) << "obj" << std::setw(18) << "kernel" << std::right << std::setw(14) << "ns/op"
+              << std::setw(14) << "bytes/op" << std::setw(10) << "GB/s" << std::setw(10) << "heap/op" << std::setw(10) << "arena/op" << std::endl;
+    try {
+        for (int objective = 0; objective < 3; ++objective) {
+            if (objectives.find(names[objective]) == std::string::npos) {
+                continue;
+            }
+            spec.objective = objective;
+            spec.density = density[objective];
+            std::string dir = instances + "/micro-" + names[objective];
+            generate(spec, dir);
+            auto x = std::make_unique<Fixture>();
+            setup(*x, objective, dir, depth);
+            run(*x, seconds, filter);
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
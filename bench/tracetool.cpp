@@ -0,0 +1,294 @@
+/* This file is part of the code presented in the paper
+
+	"An Exact Solver for Submodular Knapsack Problems"
+
+by Sabine Münch and Stephen Raach
+==============================================================================*/
+
+// analysis of a search tree trace written by main --trace file
+// summary: nodes, time, oracle calls and decisions per depth, tightness of the bound compared with the best values below a node
+// replay:  takes the node decisions again with another bound or ordering rule on the recorded candidates, no oracle is called
+// csv:     one line per node
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <functional>
+#include <cmath>
+#include "../Trace.h"
+
+using Reason = Trace::Reason;
+
+// trace with the subtree values of all nodes, indexed by node id
+struct Tree {
+    Trace::Header header;
+    std::vector<Trace::Record> records;
+    std::vector<Trace::Entry> entries;
+    std::vector<size_t> first;
+
+    std::vector<size_t> index;              // record of node id
+    std::vector<std::vector<uint32_t>> children;
+    std::vector<float> best;                // best s_value in the subtree
+    std::vector<uint64_t> nodes;            // nodes in the subtree
+    std::vector<uint64_t> nanoseconds;      // time of the subtree
+    std::vector<uint64_t> oracle_calls;     // oracle calls of the subtree
+    float optimum = 0.0f;
+
+    const Trace::Record& node(uint32_t id) const { return records[index[id]]; }
+};
+
+static bool load(const std::string& path, Tree& t) {
+    if (!Trace::read(path, t.header, t.records, t.entries, t.first)) {
+        return false;
+    }
+    size_t n = t.records.size();
+    t.index.assign(n, 0);
+    t.children.assign(n, {});
+    t.best.assign(n, 0.0f);
+    t.nodes.assign(n, 0);
+    t.nanoseconds.assign(n, 0);
+    t.oracle_calls.assign(n, 0);
+    // every id from 0 to n-1 appears once, otherwise the trace is incomplete
+    std::vector<char> seen(n, 0);
+    for (size_t k = 0; k < n; ++k) {
+        const Trace::Record& r = t.records[k];
+        if (r.id >= n || r.parent >= n || seen[r.id]) {
+            return false;
+        }
+        seen[r.id] = 1;
+        t.index[r.id] = k;
+    }
+    // records are in post-order, so every subtree is complete when its root is read
+    for (const Trace::Record& r : t.records) {
+        t.best[r.id] = std::max(t.best[r.id], r.s_value);
+        t.nodes[r.id] += 1;
+        t.nanoseconds[r.id] += r.nanoseconds;
+        t.oracle_calls[r.id] += r.oracle_calls;
+        t.optimum = std::max(t.optimum, r.s_value);
+        if (r.parent != r.id) {
+            t.children[r.parent].push_back(r.id);
+            t.best[r.parent] = std::max(t.best[r.parent], t.best[r.id]);
+            t.nodes[r.parent] += t.nodes[r.id];
+            t.nanoseconds[r.parent] += t.nanoseconds[r.id];
+            t.oracle_calls[r.parent] += t.oracle_calls[r.id];
+        }
+    }
+    for (auto& c : t.children) {
+        std::sort(c.begin(), c.end());
+    }
+    return true;
+}
+
+static void summary(const Tree& t) {
+    struct Depth {
+        uint64_t nodes = 0, nanoseconds = 0, oracle_calls = 0, candidates = 0, removed = 0;
+        uint64_t reasons[7] = {0, 0, 0, 0, 0, 0, 0};
+        uint64_t bounded = 0;   // nodes with a bound
+        double gap = 0.0;       // sum of (bound - best value below the node) / optimum
+        uint64_t needless = 0;  // branched nodes whose bound is not above the optimum
+    };
+    std::vector<Depth> depths;
+    uint64_t total_ns = 0, total_nodes = t.records.size();
+    for (const Trace::Record& r : t.records) {
+        if (r.depth >= depths.size()) {
+            depths.resize(r.depth + 1);
+        }
+        Depth& d = depths[r.depth];
+        d.nodes++;
+        d.nanoseconds += r.nanoseconds;
+        d.oracle_calls += r.oracle_calls;
+        d.candidates += r.candidates;
+        d.removed += r.removed;
+        d.reasons[static_cast<int>(r.reason)]++;
+        total_ns += r.nanoseconds;
+        if (!std::isnan(r.bound)) {
+            d.bounded++;
+            d.gap += (r.bound - t.best[r.id]) / std::max(t.optimum, 1e-9f);
+            if (r.reason == Reason::Branch && r.bound <= t.optimum) {
+                d.needless++;
+            }
+        }
+    }
+
+    std::cout << "solver: " << t.header.solver << " objective: " << t.header.objective << " capacity: " << t.header.capacity
+              << " nodes: " << total_nodes << " time: " << total_ns * 1e-9 << " s optimum: " << t.optimum << std::endl;
+    std::cout << std::setw(5) << "depth" << std::setw(10) << "nodes" << std::setw(8) << "%nodes" << std::setw(8) << "%time"
+              << std::setw(12) << "oracle" << std::setw(8) << "|C|" << std::setw(9) << "branch" << std::setw(9) << "SUB" << std::setw(9) << "EP"
+              << std::setw(9) << "capacity" << std::setw(9) << "leaf" << std::setw(7) << "time" << std::setw(7) << "DP" << std::setw(9) << "CR rem" << std::setw(9) << "gap"
+              << std::setw(10) << "needless" << std::endl;
+    std::cout << std::fixed;
+    for (size_t depth = 0; depth < depths.size(); ++depth) {
+        const Depth& d = depths[depth];
+        if (d.nodes == 0) {
+            continue;
+        }
+        std::cout << std::setw(5) << depth << std::setw(10) << d.nodes
+                  << std::setprecision(1) << std::setw(8) << 100.0 * d.nodes / total_nodes << std::setw(8) << 100.0 * d.nanoseconds / std::max<uint64_t>(total_ns, 1)
+                  << std::setw(12) << d.oracle_calls << std::setw(8) << static_cast<double>(d.candidates) / d.nodes;
+        for (int reason = 0; reason < 7; ++reason) {
+            std::cout << std::setw(reason >= 5 ? 7 : 9) << d.reasons[reason];
+        }
+        std::cout << std::setw(9) << d.removed << std::setprecision(3) << std::setw(9) << (d.bounded ? d.gap / d.bounded : 0.0)
+                  << std::setw(10) << d.needless << std::endl;
+    }
+    std::cout << std::defaultfloat;
+    std::cout << "gap: mean of (bound - best value below the node) / optimum over the nodes with a bound" << std::endl;
+    std::cout << "needless: branched nodes whose bound is not above the optimum, they are pruned if the optimum is known in advance" << std::endl;
+}
+
+// bound rules of the replay, capacity is the capacity left at the node and entries are the recorded candidates
+using Rule = std::function<float(std::vector<Trace::Entry>, int)>;
+
+// fractional knapsack of the entries in their order
+static float pack(const std::vector<Trace::Entry>& entries, int capacity) {
+    float value = 0.0f;
+    for (const Trace::Entry& e : entries) {
+        if (e.weight <= capacity) {
+            capacity -= e.weight;
+            value += e.ratio * e.weight;
+        } else {
+            value += e.ratio * capacity;
+            break;
+        }
+    }
+    return value;
+}
+
+static bool rule(const std::string& name, Rule& bound) {
+    auto sorted = [](auto key) {
+        return [key](std::vector<Trace::Entry> entries, int capacity) {
+            std::stable_sort(entries.begin(), entries.end(), [&](const Trace::Entry& a, const Trace::Entry& b) { return key(a) > key(b); });
+            return pack(entries, capacity);
+        };
+    };
+    if (name == "sub") { // the bound of the solvers: decreasing relative gain
+        bound = sorted([](const Trace::Entry& e) { return e.ratio; });
+    }
+    else if (name == "order:recorded") { // order of the candidate set at the decision
+        bound = [](std::vector<Trace::Entry> entries, int capacity) { return pack(entries, capacity); };
+    }
+    else if (name == "order:gain") { // decreasing absolute gain
+        bound = sorted([](const Trace::Entry& e) { return e.ratio * e.weight; });
+    }
+    else if (name == "order:weight") { // increasing weight
+        bound = sorted([](const Trace::Entry& e) { return -static_cast<float>(e.weight); });
+    }
+    else if (name.rfind("scale:", 0) == 0) { // relative gains scaled by a factor
+        float factor = std::stof(name.substr(6));
+        Rule base;
+        rule("sub", base);
+        bound = [base, factor](std::vector<Trace::Entry> entries, int capacity) { return factor * base(entries, capacity); };
+    }
+    else {
+        return false;
+    }
+    return true;
+}
+
+// replays the decisions of all nodes with a bound, the recorded best value at a decision is kept
+// a node that was branched but is pruned by the rule saves its subtree, a node that was pruned but is not pruned by the rule has an unknown subtree
+static void replay(const Tree& t, const std::string& name, const Rule& bound) {
+    uint64_t nodes = 0, nanoseconds = 0, oracle_calls = 0;
+    uint64_t pruned = 0, opened = 0, agree = 0, lost = 0;
+    double difference = 0.0; // sum of |rule - recorded bound| / optimum
+    uint64_t compared = 0;
+    float tolerance = 1e-5f * std::max(1.0f, t.optimum);
+
+    std::vector<uint32_t> stack = {0};
+    while (!stack.empty()) {
+        uint32_t id = stack.back();
+        stack.pop_back();
+        const Trace::Record& r = t.node(id);
+        nodes++;
+        nanoseconds += r.nanoseconds;
+        oracle_calls += r.oracle_calls;
+
+        bool was_pruned = r.reason != Reason::Branch;
+        bool prune = was_pruned;
+        if (r.entries > 0 && (r.reason == Reason::Branch || r.reason == Reason::SUB)) {
+            size_t k = t.index[id];
+            std::vector<Trace::Entry> entries(t.entries.begin() + t.first[k], t.entries.begin() + t.first[k] + r.entries);
+            float value = r.s_value + bound(entries, r.capacity);
+            prune = value <= r.s_best;
+            if (!std::isnan(r.bound)) {
+                difference += std::fabs(value - r.bound) / std::max(t.optimum, 1e-9f);
+                compared++;
+            }
+        }
+        if (prune == was_pruned) {
+            agree++;
+        }
+        else if (prune) { // subtree is skipped
+            pruned++;
+            if (t.best[id] >= t.optimum - tolerance && r.s_value < t.optimum - tolerance) {
+                lost++;
+            }
+            continue;
+        }
+        else {
+            opened++;
+        }
+        for (auto it = t.children[id].rbegin(); it != t.children[id].rend(); ++it) {
+            stack.push_back(*it);
+        }
+    }
+
+    std::cout << "rule: " << name << std::endl;
+    std::cout << "nodes: " << nodes << " of " << t.records.size() << " (" << std::fixed << std::setprecision(1) << 100.0 * nodes / t.records.size() << "%)"
+              << " time: " << 100.0 * nanoseconds / std::max<uint64_t>(t.nanoseconds[0], 1) << "%"
+              << " oracle calls: " << 100.0 * oracle_calls / std::max<uint64_t>(t.oracle_calls[0], 1) << "%" << std::defaultfloat << std::endl;
+    std::cout << "same decision: " << agree << " pruned instead of branched: " << pruned << " branched instead of pruned: " << opened
+              << " (subtrees not in the trace)" << std::endl;
+    std::cout << "mean |bound - recorded bound| / optimum: " << (compared ? difference / compared : 0.0) << std::endl;
+    std::cout << (lost ? "optimum LOST in " + std::to_string(lost) + " pruned subtrees" : std::string("optimum kept")) << std::endl;
+}
+
+static void csv(const Tree& t) {
+    std::cout << "id,parent,depth,reason,item,capacity,candidates,removed,s_value,s_best,bound,best_below,oracle_calls,nanoseconds,entries" << std::endl;
+    std::cout << std::setprecision(9);
+    for (uint32_t id = 0; id < t.records.size(); ++id) {
+        const Trace::Record& r = t.node(id);
+        std::cout << r.id << "," << r.parent << "," << r.depth << "," << Trace::name(r.reason) << "," << r.item << "," << r.capacity << ","
+                  << r.candidates << "," << r.removed << "," << r.s_value << "," << r.s_best << "," << r.bound << "," << t.best[id] << ","
+                  << r.oracle_calls << "," << r.nanoseconds << "," << r.entries << std::endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " summary <trace>" << std::endl
+                  << "       " << argv[0] << " replay <trace> <rule>...   rules: sub, order:recorded, order:gain, order:weight, scale:<factor>" << std::endl
+                  << "       " << argv[0] << " csv <trace>" << std::endl;
+        return 1;
+    }
+    std::string command = argv[1];
+    Tree t;
+    if (!load(argv[2], t) || t.records.empty()) {
+        std::cerr << "cannot read trace or trace incomplete: " << argv[2] << std::endl;
+        return 1;
+    }
+    if (command == "summary") {
+        summary(t);
+    }
+    else if (command == "replay") {
+        for (int a = 3; a < argc; ++a) {
+            Rule bound;
+            if (!rule(argv[a], bound)) {
+                std::cerr << "unknown rule: " << argv[a] << std::endl;
+                return 1;
+            }
+            replay(t, argv[a], bound);
+        }
+    }
+    else if (command == "csv") {
+        csv(t);
+    }
+    else {
+        std::cerr << "unknown command: " << command << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -6,8 +6,15 @@ by Sabine Münch and Stephen Raach
 ==============================================================================*/
 
 #include "functions.h"
+#include "PackingTree.h"
 #include <iostream>
-#include <queue>
+#include <algorithm>
+#include <cmath>
+#ifdef __AVX__
+#include <immintrin.h>
+#elif defined(__SSE__)
+#include <xmmintrin.h>
+#endif
 
 std::chrono::high_resolution_clock::time_point startzeit;
 std::chrono::high_resolution_clock::time_point end_time_limit;
@@ -15,66 +22,212 @@ std::chrono::high_resolution_clock::time_point end_time_limit;
 // input a vector S, an integer (item) c, and the objective value s_value of S
 // output marginal gain of adding item c to S
 float Solver::z(const std::vector<int>& S, const int c, float s_value) {
-    std::vector<int> updated_S(S);  // updated_S is S+c
-    updated_S.push_back(c);
-    return f(updated_S) - s_value; // return is f(updated_S)-f(S) = f(S+c)-f(S)
+    float value;
+    if (S.size() <= 1 && gaintable.find(S, c, value)) { // f(S+c) is stored in the gain table
+        value -= s_value;
+    }
+    else if (gain) { // marginal gain from the incremental state of the objective
+        value = gain(S, c);
+    }
+    else {
+        updated_S.assign(S.begin(), S.end());  // updated_S is S+c, its buffer is reused between calls
+        updated_S.push_back(c);
+        value = f(updated_S) - s_value; // value is f(updated_S)-f(S) = f(S+c)-f(S)
+    }
+    if (cache.enabled()) { // the child S+c takes its value from the cache
+        cache.store(cache.gainkey(cache.hash(S), c), value);
+    }
+    return value;
+}
+
+// input a set S and the best value s_best known to the search
+// output f(S), taken as f(S-v) + z(S-v, v) for the last item v of S if both are in the gain cache
+// f is evaluated if S may improve s_best, so every published solution value is computed with full precision
+float Solver::value(const std::vector<int>& S, float s_best) {
+    if (!cache.enabled()) {
+        return f(S);
+    }
+    uint64_t h = cache.hash(S);
+    float s_value;
+    if (!S.empty()) {
+        uint64_t parent = cache.without(h, S.back());
+        float parent_value, gain_value;
+        if (cache.find(parent, parent_value) && cache.find(cache.gainkey(parent, S.back()), gain_value)) {
+            s_value = parent_value + gain_value;
+            if (s_value < s_best - std::max(tolerance, cache_slack) * std::fabs(s_best)) { // rounding of the gains can not make S better than s_best
+                cache.hits++;
+                cache.store(h, s_value);
+                return s_value;
+            }
+        }
+    }
+    s_value = f(S);
+    cache.store(h, s_value);
+    return s_value;
+}
+
+// input current set S with objective value s_value and the best value s_best known to the search
+// output new best value, S is published to the shared incumbent if it is better, improvements of other solvers are taken over
+float Solver::improve(const std::vector<int>& S, float s_value, float s_best) {
+    if (s_value > s_best) {
+        incumbent->publish(s_value, S);
+        if (shared) {
+            shared->publish(s_value, S);
+        }
+    }
+    float best = std::max({s_value, s_best, incumbent->value()});
+    return shared ? std::max(best, shared->value()) : best;
+}
+
+// input a vector S, n items C[0], ..., C[n-1] and the objective value s_value of S
+// output marginal gains out[k] of adding C[k] to S, evaluated together if the objective provides a batch
+void Solver::zbatch(const std::vector<int>& S, const int* C, size_t n, float s_value, float* out) {
+    if (S.empty() && gaintable.built()) { // root: the gains are the singletons evaluated at startup
+        for (size_t k = 0; k < n; ++k) {
+            out[k] = gaintable.single(C[k]) - s_value;
+        }
+    }
+    else if (gains && S.size() > 1) { // S+c is never stored in the gain table
+        gains(S, C, n, out);
+    }
+    else { // z stores the gains in the cache
+        for (size_t k = 0; k < n; ++k) {
+            out[k] = z(S, C[k], s_value);
+        }
+        return;
+    }
+    if (cache.enabled()) {
+        uint64_t h = cache.hash(S);
+        for (size_t k = 0; k < n; ++k) {
+            cache.store(cache.gainkey(h, C[k]), out[k]);
+        }
+    }
+}
+
+// input a vector S, an item c not reevaluated at S and the previous gains
+// output relative gain used as current gain of c: the previous gain, or the pair bound of the gain table if it is smaller
+float Solver::stalegain(const std::vector<int>& S, int c, const Gains& previous_gains) {
+    return std::min(previous_gains.at(c), gaintable.upper(S, c) / items.weight[c]);
 }
 
 // dynamic candidate ordering
 // input a vector S, a vector c, the objective value s_value of S and the capacity left in the knapsack (capacity=B-weight(S))
 // output sorted_C a vector of all items that can be added to S without exeeding the knapsack capacity ordered according to the relative marginal gain of adding an item to S
-std::vector<int> Solver::DCO(const std::vector<int>& S, std::vector<int> C, const float s_value, const int capacity) {
+// only the prefix needed by SUB is ordered, the number of ordered items is returned, the rest is ordered by order() if the node is not pruned
+std::pair<Candidates, size_t> Solver::DCO(const std::vector<int>& S, const Candidates& C, const float s_value, const int capacity) {
     // delete all items from C that can not fit into the knapsack 
-    C.erase(std::remove_if(C.begin(), C.end(), [this,capacity](int c) {
-        return items[c].weight > capacity;  
-    }), C.end());
-    // Max-Heap for ordering remaining items according to relative marginal gain
-    auto cmp = [this](int a, int b) {
-        return (items[a].value / items[a].weight) < (items[b].value / items[b].weight);
-    };
-
-    std::priority_queue<int, std::vector<int>, decltype(cmp)> max_heap(cmp);
-    // iterating over all items in C
+    Candidates fit(&arena);
+    fit.reserve(C.size());
     for (int c : C) {
-        float marginal_gain = z(S, c, s_value);  // calculating marginal gain of adding c to S
-        items[c].value = marginal_gain;  // updating c's value
+        if (items.weight[c] <= capacity) {
+            fit.push_back(c);
+        }
+    }
+    // calculating marginal gains of adding the items to S, all at once
+    std::pmr::vector<float> marginal_gain(fit.size(), &arena);
+    zbatch(S, fit.data(), fit.size(), s_value, marginal_gain.data());
 
-        max_heap.push(c); // adding c to the max-heap
+    // remaining items with their relative marginal gain
+    std::pmr::vector<std::pair<int, float>> ratios(&arena);
+    ratios.reserve(fit.size());
+    for (size_t k = 0; k < fit.size(); ++k) {
+        int c = fit[k];
+        items.value[c] = marginal_gain[k];  // updating c's value
+        ratios.push_back({c, items.value[c] * items.inv_weight[c]});
     }
-    // extract itmes from heap to a vector
-    std::vector<int> sorted_C;
-    while (!max_heap.empty()) {
-        sorted_C.push_back(max_heap.top());
-        max_heap.pop();
+    // order the items up to the first item that does not fit
+    size_t sorted = greedyorder(ratios, capacity);
+
+    // extract items to a vector
+    Candidates sorted_C(&arena);
+    sorted_C.reserve(ratios.size());
+    for (const auto& ratio : ratios) {
+        sorted_C.push_back(ratio.first);
     }
+    return {std::move(sorted_C), sorted};
+}
 
-    return sorted_C;  
+// partial ordering for the greedy knapsack
+// input pairs of items and relative gains, the capacity left in the knapsack
+// orders the items according to decreasing relative gain up to the first item that does not fit, the items behind are selected but not ordered
+// the next items are selected by nth_element in chunks of doubling size and only the chunk is sorted
+// output the number of ordered items at the front of ratios
+size_t Solver::greedyorder(std::pmr::vector<std::pair<int, float>>& ratios, int capacity) {
+    auto cmp = [](const std::pair<int, float>& a, const std::pair<int, float>& b) {
+        return a.second > b.second;
+    };
+    size_t sorted = 0;
+    size_t chunk = 16;
+    size_t n = ratios.size();
+    while (sorted < n) {
+        size_t end = std::min(n, sorted + chunk);
+        if (end < n) { // select the best items of the remaining ones
+            std::nth_element(ratios.begin() + sorted, ratios.begin() + end, ratios.end(), cmp);
+        }
+        std::sort(ratios.begin() + sorted, ratios.begin() + end, cmp);
+        for (; sorted < end; ++sorted) { // pack the chunk
+            if (items.weight[ratios[sorted].first] > capacity) {
+                return sorted + 1; // item that does not fit is ordered
+            }
+            capacity -= items.weight[ratios[sorted].first];
+        }
+        chunk *= 2;
+    }
+    return sorted;
+}
+
+// ordering for Lazy Evaluations
+// input pairs of items and relative gains, the first fresh pairs have updated gains, the others have the gains of the parent node and keep its order
+// the updated items are sorted and merged with the others, so the ordering costs O(fresh log fresh + |C|) instead of sorting all items
+// the others are sorted as well if the pair bound of the gain table changed their order
+// output the number of ordered items, all items are ordered
+size_t Solver::lazyorder(std::pmr::vector<std::pair<int, float>>& ratios, size_t fresh) {
+    auto cmp = [](const std::pair<int, float>& a, const std::pair<int, float>& b) {
+        return a.second > b.second;
+    };
+    std::sort(ratios.begin(), ratios.begin() + fresh, cmp);
+    if (!std::is_sorted(ratios.begin() + fresh, ratios.end(), cmp)) {
+        std::sort(ratios.begin() + fresh, ratios.end(), cmp);
+    }
+    std::pmr::vector<std::pair<int, float>> merged(ratios.size(), &arena);
+    std::merge(ratios.begin(), ratios.begin() + fresh, ratios.begin() + fresh, ratios.end(), merged.begin(), cmp);
+    ratios.swap(merged);
+    return ratios.size();
+}
+
+// orders the items of C behind the first sorted items according to decreasing relative gain
+// the relative gains are current_gains or the relative item values if current_gains is nullptr
+void Solver::order(Candidates& C, size_t sorted, const Gains* current_gains) {
+    if (sorted >= C.size()) {
+        return;
+    }
+    std::pmr::vector<std::pair<int, float>> ratios(&arena);
+    ratios.reserve(C.size() - sorted);
+    for (size_t i = sorted, n = C.size(); i < n; ++i) {
+        int c = C[i];
+        ratios.push_back({c, current_gains ? current_gains->at(c) : items.value[c] * items.inv_weight[c]});
+    }
+    std::sort(ratios.begin(), ratios.end(), [](const std::pair<int, float>& a, const std::pair<int, float>& b) {
+        return a.second > b.second;
+    });
+    for (size_t i = 0; i < ratios.size(); ++i) {
+        C[sorted + i] = ratios[i].first;
+    }
 }
 
 // SUB heuritic for pruning nodes
 // input a vector C containing all items in the knapsack set and the capacity left in the knapsack (capacity = B-w(S))
 // output an upper bound for the total value that can be added to the currently packed knapsack, when S is already packed
 // uses greedy for solving a modular fractional knapsack problem exactly
-float Solver::SUB(std::vector<int>& C, int capacity) {
-    // total weight of all items in C
-    int total_weight = std::accumulate(C.begin(), C.end(), 0, [this](int sum, int c) {
-        return sum + items[c].weight;
-    });
-    // pack all items in C if total weight is less/equal to left capacity
-    if (total_weight <= capacity) {
-        return std::accumulate(C.begin(), C.end(), 0.0f, [this](float sum, int c) {
-            return sum + items[c].value;
-        });
-    }
-    // fractional packing according to relative increase if not all items can be packed
+float Solver::SUB(const Candidates& C, int capacity) {
+    // fractional packing according to relative increase, all items in C are packed if their total weight is less/equal to left capacity
     float total_value = 0.0f;
     for (int c : C) { // iterating over all items in c
-        const Item& item = items[c];
-        if (item.weight <= capacity) { // if item c fits it is packed
-            capacity -= item.weight; // left capacity is reduced
-            total_value += item.value; // total_value of the knapsack is increased
+        if (items.weight[c] <= capacity) { // if item c fits it is packed
+            capacity -= items.weight[c]; // left capacity is reduced
+            total_value += items.value[c]; // total_value of the knapsack is increased
         } else {
-            total_value += item.value / item.weight * capacity; // if item c does not fit into the knapsack, we add as much of it as possible
+            total_value += items.value[c] / items.weight[c] * capacity; // if item c does not fit into the knapsack, we add as much of it as possible
             break; // knapsack capcity is reached, we stop packing
         }
     }
@@ -82,63 +235,39 @@ float Solver::SUB(std::vector<int>& C, int capacity) {
 }
 
 // SUB_CR heuristic for pruning nodes
-// exact the same as SUB, only that the set that is packed into the knapsack is also stored and returned.
-std::pair<float, std::vector<int>> Solver::SUB_CR(const std::vector<int>& C, int capacity) {
+// exact the same as SUB, only that the number of items packed completely into the knapsack is also returned.
+// the packed items are the prefix of C up to this position
+std::pair<float, size_t> Solver::SUB_CR(const Candidates& C, int capacity) {
     float total_value = 0.0f;
-    // total weight of all items in C
-    int total_weight = 0;
-    for (int c : C) {
-        total_weight += items[c].weight;
-    }
-    
-    // pack all items in C if total weight is less/equal to capacity
-    if (total_weight <= capacity) {
-        for (int c : C) {
-            total_value += items[c].value;
-        }
-        return {total_value, C};  // Return as std::pair
-    }
-    // pack according to steepest relativ gain if not all items can be packed
-    std::vector<int> knapsackset;
+    // pack according to steepest relativ gain, all items in C are packed if their total weight is less/equal to capacity
+    size_t split = 0;
     
     for (int c : C) {
-        const Item& item = items[c];
         // add item if it fits
-        if (item.weight <= capacity) {
-            capacity -= item.weight;
-            total_value += item.value;
-            knapsackset.push_back(c);
+        if (items.weight[c] <= capacity) {
+            capacity -= items.weight[c];
+            total_value += items.value[c];
+            split++;
         }
         // add fractional part if item does not fit
         else {
-            float frac = item.value / item.weight * capacity;
+            float frac = items.value[c] / items.weight[c] * capacity;
             total_value += frac;
             break;  // break when capacity is reached
         }
     }
-    return {total_value, knapsackset};  
+    return {total_value, split};
 }
 
 // SUB_LE heuristic for pruning SUB
-// exact the same as SUB, only that current_gains are used instead of item.value
-float Solver::SUB_LE(std::vector<int>& C, int capacity, const std::unordered_map<int, float>& current_gains) {
-    // total weight of all items in C
-    int total_weight = std::accumulate(C.begin(), C.end(), 0, [this](int sum, int c) {
-        return sum + items[c].weight;
-    });
-    // pack all items in C if total weight is less/equal to capacity
-    if (total_weight <= capacity) {
-        return std::accumulate(C.begin(), C.end(), 0.0f, [&](float sum, int c) {
-            return sum + current_gains.at(c)*items[c].weight;
-        });
-    }
-    // pack according to steepest relativ gain if not all items can be packed
+// exact the same as SUB, only that current_gains are used instead of the item values
+float Solver::SUB_LE(const Candidates& C, int capacity, const Gains& current_gains) {
+    // pack according to steepest relativ gain, all items in C are packed if their total weight is less/equal to capacity
     float total_value = 0.0f;
     for (int c : C) {
-        const Item& item = items[c];
-        if (item.weight <= capacity) {
-            capacity -= item.weight;
-            total_value += (current_gains.at(c)*items[c].weight);
+        if (items.weight[c] <= capacity) {
+            capacity -= items.weight[c];
+            total_value += (current_gains.at(c)*items.weight[c]);
         } else {
             total_value += current_gains.at(c) * capacity;
             break;
@@ -148,26 +277,14 @@ float Solver::SUB_LE(std::vector<int>& C, int capacity, const std::unordered_map
 }
 
 // SUB_EP heuristic for pruning nodes
-// exact the same as SUB, only that current_gains are used instead of item.value (same as SUB_LE)
-float Solver::SUB_EP(std::vector<int>& C, int capacity, const std::unordered_map<int, float>& current_gains) {
-    // total weight of all items in C
-    int total_weight = std::accumulate(C.begin(), C.end(), 0, [this](int sum, int c) {
-        return sum + items[c].weight;
-    });
-    // pack all items in C if total weight is less/equal to capacity
-    if (total_weight <= capacity) {
-        float gesamtwert = std::accumulate(C.begin(), C.end(), 0.0f, [&](float sum, int c) {
-            return sum + current_gains.at(c)*items[c].weight;
-        });
-        return gesamtwert;
-    }
-    // pack according to steepest relativ gain if not all items can be packed
+// exact the same as SUB, only that current_gains are used instead of the item values (same as SUB_LE)
+float Solver::SUB_EP(const Candidates& C, int capacity, const Gains& current_gains) {
+    // pack according to steepest relativ gain, all items in C are packed if their total weight is less/equal to capacity
     float total_value = 0.0f;
     for (int c : C) {
-        const Item& item = items[c];
-        if (item.weight <= capacity) {
-            capacity -= item.weight;
-            total_value += (current_gains.at(c)*items[c].weight);
+        if (items.weight[c] <= capacity) {
+            capacity -= items.weight[c];
+            total_value += (current_gains.at(c)*items.weight[c]);
         } else {
             total_value += current_gains.at(c) * capacity;
             break;
@@ -177,30 +294,17 @@ float Solver::SUB_EP(std::vector<int>& C, int capacity, const std::unordered_map
 }
 
 // SUB_LECR heuristic for pruning SUB
-// exact the same as SUB_CR, only that current_gains are used instead of item.value
-std::pair<float, std::vector<int>> Solver::SUB_LECR(const std::vector<int>& C, int capacity, const std::unordered_map<int, float>& current_gains) {
-    // total weight of all items in C
-    int total_weight = std::accumulate(C.begin(), C.end(), 0, [this](int sum, int c) {
-        return sum + items[c].weight;
-    });
-    
-    // pack all items in C if total weight is less/equal to capacity
-    if (total_weight <= capacity) {
-        float value = std::accumulate(C.begin(), C.end(), 0.0f, [&](float sum, int c) {
-            return sum + current_gains.at(c)*items[c].weight;
-        });
-        return {value, C};  // Rückgabe als std::pair
-    }
-    // pack according to steepest relativ gain if not all items can be packed
-    std::vector<int> knapsackset;
+// exact the same as SUB_CR, only that current_gains are used instead of the item values
+std::pair<float, size_t> Solver::SUB_LECR(const Candidates& C, int capacity, const Gains& current_gains) {
+    // pack according to steepest relativ gain, all items in C are packed if their total weight is less/equal to capacity
+    size_t split = 0;
     float total_value = 0.0f;
     for (int c : C) {
-        const Item& item = items[c];
         // add item if it fits
-        if (item.weight <= capacity) {
-            capacity -= item.weight;
-            total_value += (current_gains.at(c)*item.weight);
-            knapsackset.push_back(c);
+        if (items.weight[c] <= capacity) {
+            capacity -= items.weight[c];
+            total_value += (current_gains.at(c)*items.weight[c]);
+            split++;
         }
         // add fractional part if item does not fit
         else {
@@ -208,525 +312,653 @@ std::pair<float, std::vector<int>> Solver::SUB_LECR(const std::vector<int>& C, i
             break;  // break when capacity is reached
         }
     }
-    return {total_value, knapsackset};  
+    return {total_value, split};
+}
+
+// row of the knapsack table with one more item of weight w and gain v
+// row[j] = max(next[j], next[j-w]+v), the entries of a row are independent and computed 8 (AVX) or 4 (SSE) at once
+static void knapsackrow(const float* next, float* row, int capacity, int w, float v) {
+    int j = std::min(w, capacity + 1);
+    std::copy(next, next + j, row); // the item does not fit
+#ifdef __AVX__
+    __m256 gain8 = _mm256_set1_ps(v);
+    for (; j + 8 <= capacity + 1; j += 8) {
+        __m256 take = _mm256_add_ps(_mm256_loadu_ps(next + j - w), gain8);
+        _mm256_storeu_ps(row + j, _mm256_max_ps(_mm256_loadu_ps(next + j), take));
+    }
+#endif
+#ifdef __SSE__
+    __m128 gain4 = _mm_set1_ps(v);
+    for (; j + 4 <= capacity + 1; j += 4) {
+        __m128 take = _mm_add_ps(_mm_loadu_ps(next + j - w), gain4);
+        _mm_storeu_ps(row + j, _mm_max_ps(_mm_loadu_ps(next + j), take));
+    }
+#endif
+    for (; j <= capacity; ++j) {
+        row[j] = std::max(next[j], next[j - w] + v);
+    }
+}
+
+// DP bound for pruning nodes and children
+// input a vector C, the capacity left in the knapsack and the current gains (the item values are used if current_gains is nullptr)
+// output the 0/1 knapsack table of C with the current gains as modular item values, it is built from the last item to the first one
+// f(S+X)-f(S) is at most the sum of the gains of X, so at(0, capacity) is an upper bound like SUB and never larger than SUB
+// the table is only built if it has at most dp_cells entries
+Solver::KnapsackDP Solver::knapsack(const Candidates& C, int capacity, const Gains* current_gains) {
+    KnapsackDP D(&arena);
+    size_t width = static_cast<size_t>(capacity) + 1;
+    if ((C.size() + 1) * width > dp_cells) {
+        return D;
+    }
+    D.capacity = capacity;
+    D.rows = C.size() + 1;
+    D.table.assign(D.rows * width, 0.0f); // the last row is the empty knapsack
+    D.weight.resize(C.size());
+    D.value.resize(C.size());
+    for (size_t k = C.size(); k-- > 0;) {
+        int c = C[k];
+        D.weight[k] = items.weight[c];
+        D.value[k] = current_gains ? current_gains->at(c) * items.weight[c] : items.value[c];
+        knapsackrow(D.table.data() + (k + 1) * width, D.table.data() + k * width, capacity, D.weight[k], D.value[k]);
+    }
+    return D;
+}
+
+// prefix sums for candidate reduction
+// input a vector C ordered according to relative gain, the capacity left in the knapsack and the current gains (the item values are used if current_gains is nullptr)
+// output cumulative weights and values of the items packed by the greedy knapsack, the first item that does not fit is at position split
+Solver::KnapsackPrefix Solver::prefix(const Candidates& C, int capacity, const Gains* current_gains) {
+    KnapsackPrefix P(&arena);
+    P.weight.push_back(0);
+    P.value.push_back(0.0f);
+    for (int c : C) {
+        if (P.weight.back() + items.weight[c] > capacity) { // break at the first item that does not fit
+            break;
+        }
+        P.weight.push_back(P.weight.back() + items.weight[c]);
+        P.value.push_back(P.value.back() + (current_gains ? current_gains->at(c)*items.weight[c] : items.value[c]));
+        P.ratio.push_back(current_gains ? current_gains->at(c) : items.value[c] / items.weight[c]);
+    }
+    P.split = P.ratio.size();
+    if (removed.size() < items.size()) {
+        removed.resize(items.size(), 0);
+    }
+    return P;
+}
+
+// deletes all items marked in removed from C in one pass and resets their marks
+void Solver::compact(Candidates& C) {
+    size_t k = 0;
+    for (int c : C) {
+        if (removed[c]) {
+            removed[c] = 0;
+        } else {
+            C[k++] = c;
+        }
+    }
+    C.resize(k);
+}
+
+// fractional knapsack value of C for a reduced capacity
+// input prefix sums P of C, the vector C, the reduced capacity and the current gains (the item values are used if current_gains is nullptr)
+// output the same value as SUB_CR (SUB_LECR) applied to C, the item that does not fit is found by binary search on the prefix sums
+// items behind position split may already be marked as removed, the others are packed item by item if the whole prefix fits
+float Solver::prefixvalue(const KnapsackPrefix& P, const Candidates& C, int capacity, const Gains* current_gains) {
+    size_t k = std::upper_bound(P.weight.begin(), P.weight.end(), capacity) - P.weight.begin();
+    k = (k > 0) ? k - 1 : 0; // k items fit into the knapsack
+    if (k < P.split) { // item k is packed fractional
+        return P.value[k] + P.ratio[k] * (capacity - P.weight[k]);
+    }
+    // the whole prefix fits, continue packing behind the prefix
+    capacity -= P.weight[k];
+    float total_value = P.value[k];
+    for (size_t i = k, n = C.size(); i < n; ++i) {
+        if (removed[C[i]]) { // skip items deleted by candidate reduction
+            continue;
+        }
+        float ratio = current_gains ? current_gains->at(C[i]) : items.value[C[i]] / items.weight[C[i]];
+        if (items.weight[C[i]] <= capacity) {
+            capacity -= items.weight[C[i]];
+            total_value += current_gains ? current_gains->at(C[i])*items.weight[C[i]] : items.value[C[i]];
+        } else {
+            total_value += ratio * capacity;
+            break;
+        }
+    }
+    return total_value;
 }
 
 // CR Candidate Reduction
-// Input: candidate items in vector new_C, s_value objective value of current solution S, knapsackset the set packed by pruning heuritic SUB_CR, and the left knapsack capacity
+// Input: candidate items in vector new_C, s_value objective value of current solution S, split the number of items packed by pruning heuritic SUB_CR, and the left knapsack capacity
 // tests if an item c can be deleted from the candidate set
-// Output: updated candidate set 
-std::vector<int> Solver::CR(std::vector<int>& new_C, const float s_value, const std::vector<int>& knapsackset, const float s_best, const int capacity) {
+// Output: candidate set new_C is updated
+void Solver::CR(Candidates& new_C, const float s_value, const size_t split, const float s_best, const int capacity) {
     
-    if (knapsackset.empty()) { // if the knapsackset is empty, new_C is returned
-        return new_C;  
+    if (split == 0) { // if the knapsackset is empty, new_C is not changed
+        return;
     }
 
-    // betrachten contains all items that are in new_C and not in knapsackset, since only these once need to be tested
-    std::vector<int> betrachten;
-    std::set_difference(new_C.begin(), new_C.end(), knapsackset.begin(), knapsackset.end(), std::back_inserter(betrachten));
+    // prefix sums of new_C, computed once for all tested items
+    KnapsackPrefix P = prefix(new_C, capacity);
  
-    // iterates over betrachten
-    for (int c : betrachten) {
-        Item& item = items[c];
-        auto SUB_result = SUB_CR(new_C, capacity - item.weight); // apply pruning heuristic to obtain an upper bound the modular knapsack when S and item c are already packed
-        if (s_value + SUB_result.first + item.value <= s_best) { // if s_value + the value of c and the upper bound are less/equal to the value of the currently best solution, we do not need to consider S+c any further 
-                new_C.erase(std::remove(new_C.begin(), new_C.end(), c), new_C.end()); // c is deleted from the candidate set
-        }        
-    } 
-    return new_C; 
+    // the knapsackset is the prefix of new_C up to split, only the items behind it need to be tested
+    for (size_t i = split, n = new_C.size(); i < n; ++i) {
+        int c = new_C[i];
+        float bound = prefixvalue(P, new_C, capacity - items.weight[c]); // apply pruning heuristic to obtain an upper bound the modular knapsack when S and item c are already packed
+        if (pruned(s_value + bound + items.value[c], s_best)) { // if s_value + the value of c and the upper bound are less/equal to the value of the currently best solution, we do not need to consider S+c any further 
+            removed[c] = 1; // c is marked for deletion from the candidate set
+        }
+    }
+    compact(new_C); // delete all marked items at once
 }
 
 // CR_LE Candidate Reduction with Lazy Evaluations
-// exact the same as CR, only that current_gains are used instead of item.value
-std::vector<int> Solver::CR_LE(std::vector<int>& new_C, const float s_value, const std::vector<int>& knapsackset, const float s_best, const int capacity, const std::unordered_map<int, float>& current_gains) {
-    if (knapsackset.empty()) {
-        return new_C;  // if the knapsackset is empty, new_C is returned
+// exact the same as CR, only that current_gains are used instead of the item values
+void Solver::CR_LE(Candidates& new_C, const float s_value, const size_t split, const float s_best, const int capacity, const Gains& current_gains) {
+    if (split == 0) {
+        return;  // if the knapsackset is empty, new_C is not changed
     }
-    
-    // betrachten contains all items that are in new_C and not in knapsackset, since only these once need to be tested
-    std::vector<int> betrachten;
-    std::set_difference(new_C.begin(), new_C.end(), knapsackset.begin(), knapsackset.end(), std::back_inserter(betrachten));
-
-    // iterates over betrachten
-    for (int c : betrachten) {
-        Item& item = items[c];
-        auto SUB_result = SUB_LECR(new_C, capacity - item.weight,current_gains); // apply pruning heuristic to obtain an upper bound the modular knapsack when S and item c are already packed
-        if (s_value + SUB_result.first + current_gains.at(c)*item.weight <= s_best) { // if s_value + the value of c and the upper bound are less/equal to the value of the currently best solution, we do not need to consider S+c any further 
-            new_C.erase(std::remove(new_C.begin(), new_C.end(), c), new_C.end()); // c is deleted from the candidate set
-        }  
-    }
-    return new_C; 
-} 
 
-// track function for EP
-// packs fractional knapsack accordingt to relative marginal gain and tracks the current gain of the last packed item
-// Input: max_heap with items ordered according to relative marginal gain, knapsack capacity and current gains
-// Output: value of packed knapsack, current gain of item packed last into the knapsack
-template<typename HeapType>
-std::pair<float,float> Solver::track(HeapType max_heap, int capacity, const std::unordered_map<int, float>& current_gains) {
-    // pack according to steepest relativ gain and track current gain of last packed item
-    float total_value = 0.0f; // knapsack value
-    float schranke; // current gain of last packed item
-    while (items[max_heap.top()].weight<= capacity){
-        capacity -= items[max_heap.top()].weight; // update left capacity
-        total_value += (current_gains.at(max_heap.top())*items[max_heap.top()].weight); //update knapsack value
-        schranke = current_gains.at(max_heap.top()); // update current gain of last packed item
-        max_heap.pop(); // remove item from max_heap
-    }
-    if (capacity > 0){ // add fractional part of the next item if capacity is left
-        total_value += current_gains.at(max_heap.top()) * capacity; // update knapsack value
-        schranke = current_gains.at(max_heap.top()); // update current gain of last packed item
-    }
-    return {total_value, schranke};
-}
+    // prefix sums of new_C, computed once for all tested items
+    KnapsackPrefix P = prefix(new_C, capacity, &current_gains);
+
+    // the knapsackset is the prefix of new_C up to split, only the items behind it need to be tested
+    for (size_t i = split, n = new_C.size(); i < n; ++i) {
+        int c = new_C[i];
+        float bound = prefixvalue(P, new_C, capacity - items.weight[c], &current_gains); // apply pruning heuristic to obtain an upper bound the modular knapsack when S and item c are already packed
+        if (pruned(s_value + bound + current_gains.at(c)*items.weight[c], s_best)) { // if s_value + the value of c and the upper bound are less/equal to the value of the currently best solution, we do not need to consider S+c any further 
+            removed[c] = 1; // c is marked for deletion from the candidate set
+        }
+    }
+    compact(new_C); // delete all marked items at once
+} 
 
 // Lazy Evaluations with average decision rule
 // Input: solution set S, candidate set C, current solution value s_value, current best solution s_best, capacity, previous gains
-// Output: updated candidate set, current gains (updated with average decision rule)
-std::pair<std::vector<int>, std::unordered_map<int, float>> Solver::LE(
+// Output: updated candidate set, current gains (updated with average decision rule), number of ordered items (see DCO)
+std::tuple<Candidates, Gains, size_t> Solver::LE(
     const std::vector<int>& S,
-    const std::vector<int>& C,
+    const Candidates& C,
     const float s_value,
     const float s_best,
     const int capacity,
-    const std::unordered_map<int, float>* previous_gains
+    const Gains* previous_gains
 ) {
-    std::unordered_map<int, float> current_gains; // initialize current_gains
-    std::vector<std::pair<int, float>> ratios;  // initializes relative marginal gains
-
-    bool updated = false;  // flag for breaking the update of current gains
+    Gains current_gains(&arena); // initialize current_gains
+    current_gains.reserve(C.size());
+    std::pmr::vector<std::pair<int, float>> ratios(&arena);  // initializes relative marginal gains
+    ratios.reserve(C.size());
+    size_t sorted = 0; // number of ordered items
 
     if (!previous_gains) { // initialize current_gains if there are no previous gains
         for (int c : C) {
-            if (items[c].weight <= capacity) {
-                float ratio = items[c].value / items[c].weight;
+            if (items.weight[c] <= capacity) {
+                float ratio = items.value[c] / items.weight[c];
                 current_gains[c] = ratio;
                 ratios.push_back({c, ratio});
             }
         }
+        // order according to relative gain (ratio) up to the first item that does not fit
+        sorted = greedyorder(ratios, capacity);
     } else {
         float R = (s_best - s_value) / capacity; // benchmark for updating current gains
+        // delete all items that are to heavy
+        Candidates fit(&arena);
+        fit.reserve(C.size());
         for (int c : C) {
-            if (items[c].weight <= capacity) { // delete all items that are to heavy
-
-                if (!updated && previous_gains->at(c) >= R) { // update current gain
-                    items[c].value = z(S, c, s_value);  
-                    current_gains[c] = items[c].value / items[c].weight;
-                } else {
-                    current_gains[c] = previous_gains->at(c); // if previous gain smaller than benchmark use previous gain as current gain
-                    updated = true;  // flag to stop update
-                }
-                ratios.push_back({c, current_gains[c]});
+            if (items.weight[c] <= capacity) {
+                fit.push_back(c);
+            }
+        }
+        // the update stops at the first item with previous gain smaller than benchmark, the items in front of it are updated all at once
+        size_t fresh = 0;
+        while (fresh < fit.size() && previous_gains->at(fit[fresh]) >= R) {
+            fresh++;
+        }
+        std::pmr::vector<float> marginal_gain(fresh, &arena);
+        zbatch(S, fit.data(), fresh, s_value, marginal_gain.data());
+
+        for (size_t k = 0; k < fit.size(); ++k) {
+            int c = fit[k];
+            if (k < fresh) { // update current gain
+                items.value[c] = marginal_gain[k];
+                current_gains[c] = items.value[c] / items.weight[c];
+            } else {
+                current_gains[c] = stalegain(S, c, *previous_gains); // if previous gain smaller than benchmark use previous gain as current gain
             }
+            ratios.push_back({c, current_gains[c]});
         }
+        // C is ordered according to the previous gains, only the updated items are sorted and merged with the others
+        sorted = lazyorder(ratios, fresh);
     }
-    // Sort according to relative gain (ratio)
-    std::sort(ratios.begin(), ratios.end(), [](const std::pair<int, float>& a, const std::pair<int, float>& b) {
-        return a.second > b.second;  
-    });
-    // extract sorted items
-    std::vector<int> sorted_filtered_C;
+    // extract items
+    Candidates sorted_filtered_C(&arena);
+    sorted_filtered_C.reserve(ratios.size());
     for (const auto& ratio : ratios) {
         sorted_filtered_C.push_back(ratio.first);
     }
-    return {sorted_filtered_C, current_gains};
+    return {std::move(sorted_filtered_C), std::move(current_gains), sorted};
 }
 
 // Early Pruning EP
 // Input: solution set S, candidate set C, current solution value s_value, current best solution s_best, capacity, previous gains
 // Output: status Early Pruning true/false, C sorted
-std::tuple<bool, std::vector<int>, std::unordered_map<int, float>> Solver::EP(std::vector<int> S, std::vector<int> C,float s_value, float s_best,
-    int capacity, const std::unordered_map<int, float>* previous_gains
+std::tuple<bool, Candidates, Gains> Solver::EP(const std::vector<int>& S, const Candidates& candidates, float s_value, float s_best,
+    int capacity, const Gains* previous_gains
     ) {
     // delete all items from C that can not fit into the knapsack
-    C.erase(std::remove_if(C.begin(), C.end(), [this,capacity](int c) {
-        return items[c].weight > capacity;  
-    }), C.end());
+    Candidates C(&arena);
+    C.reserve(candidates.size());
+    for (int c : candidates) {
+        if (items.weight[c] <= capacity) {
+            C.push_back(c);
+        }
+    }
     // if candidate set empty return true
     if(C.empty()){
         return {true, {}, {}};
     }
     // initialize current gains
-    std::unordered_map<int, float> current_gains;
+    Gains current_gains(&arena);
+    current_gains.reserve(C.size());
     // if no previous gain exist, compute all relative marginal gains and check pruning conditions
     if (previous_gains == nullptr){
         // compute all relative marginal gains
-        for (int c : C){
-            items[c].value = z(S,c,s_value); 
-            current_gains[c] = items[c].value / items[c].weight;
+        std::pmr::vector<float> marginal_gain(C.size(), &arena);
+        zbatch(S, C.data(), C.size(), s_value, marginal_gain.data());
+        for (size_t k = 0; k < C.size(); ++k){
+            items.value[C[k]] = marginal_gain[k]; 
+            current_gains[C[k]] = items.value[C[k]] / items.weight[C[k]];
+        }
+        // order C according to relative marginal gains up to the first item that does not fit
+        std::pmr::vector<std::pair<int, float>> ratios(&arena);
+        ratios.reserve(C.size());
+        for (int c : C) {
+            ratios.push_back({c, current_gains[c]});
+        }
+        size_t sorted = greedyorder(ratios, capacity);
+        for (size_t k = 0; k < ratios.size(); ++k) {
+            C[k] = ratios[k].first;
         }
-        // sort C according to relative marginal gains
-        std::sort(C.begin(), C.end(), [&current_gains](int a, int b) {
-            return current_gains[a] > current_gains[b];
-        });
         // check pruning conditions
-        if(s_value + SUB_EP(C, capacity, current_gains) <= s_best){
+        if (pruned(s_value + SUB_EP(C, capacity, current_gains), s_best)) {
             return {true, {}, {}};
         }
-        return {false, C, current_gains};
+        order(C, sorted, &current_gains); // the node is not pruned, order the remaining items
+        return {false, std::move(C), std::move(current_gains)};
     }
     
     int total_weight_updated = 0; // initialize knapsack weight as zero
 
     int i = 0; // initialize counter for current item
-    int last; // initialize tracker for first item not packed item
+    int last = 0; // initialize tracker for first item not packed item
 
-    // Max-Heap for ordering items according to relative marginal gain
-    auto cmp = [this](int a, int b) {
-        return (items[a].value / items[a].weight) < (items[b].value / items[b].weight);
-    };
-    std::priority_queue<int, std::vector<int>, decltype(cmp)> max_heap(cmp);
+    // greedy order of items according to relative marginal gain
+    PackingTree greedy(&arena);
+    greedy.reserve(C.size());
 
-    std::vector<int> sorted_C; // initialize empty vector for candidate set ordered according to current gains
+    Candidates sorted_C(&arena); // initialize empty vector for candidate set ordered according to current gains
+    sorted_C.reserve(C.size());
+
+    // the packed items only depend on the weights, their marginal gains are computed all at once
+    size_t packed = 0;
+    for (int weight = 0; packed < C.size() && weight + items.weight[C[packed]] < capacity; ++packed) {
+        weight += items.weight[C[packed]];
+    }
+    std::pmr::vector<float> marginal_gain(C.size(), &arena);
+    zbatch(S, C.data(), packed, s_value, marginal_gain.data());
 
     // pack knapsack and update current gains of packed items
-    while (i < C.size() and total_weight_updated + items[C[i]].weight < capacity ){ 
-        items[C[i]].value = z(S,C[i],s_value); 
-        current_gains[C[i]] = items[C[i]].value / items[C[i]].weight; // update current gains
-        max_heap.push(C[i]); // store items in greedy order
-        total_weight_updated += items[C[i]].weight;  // update total_weight
+    while (i < C.size() and total_weight_updated + items.weight[C[i]] < capacity ){ 
+        items.value[C[i]] = marginal_gain[i]; 
+        current_gains[C[i]] = items.value[C[i]] / items.weight[C[i]]; // update current gains
+        greedy.insert(C[i], current_gains[C[i]], items.weight[C[i]]); // store items in greedy order
+        total_weight_updated += items.weight[C[i]];  // update total_weight
         i = i+1;
         last = i;
     }
 
     // if all items were packed into the knapsack
     if (last == C.size()){
-        while (!max_heap.empty()) {
-            sorted_C.push_back(max_heap.top()); // store greedy order in the vector sorted_C
-            max_heap.pop();
-        }
-        if(s_value + SUB_EP(sorted_C, capacity, current_gains) <= s_best){ // check pruning condition
+        greedy.sorted(sorted_C); // store greedy order in the vector sorted_C
+        if (pruned(s_value + SUB_EP(sorted_C, capacity, current_gains), s_best)) { // check pruning condition
             return {true, {}, {}};
         }
-        return {false, sorted_C, current_gains};
+        return {false, std::move(sorted_C), std::move(current_gains)};
     }
      
     // consider all not packed items, except the last in C(S) (special case, considered later)
     for (size_t i = last, n =C.size()-1; i < n; ++i) {
-            items[C[i]].value = z(S,C[i],s_value); 
-            current_gains[C[i]] = items[C[i]].value / items[C[i]].weight; // compute current gain
-            max_heap.push(C[i]); // insert in greedy order
+            items.value[C[i]] = z(S,C[i],s_value); 
+            current_gains[C[i]] = items.value[C[i]] / items.weight[C[i]]; // compute current gain
+            greedy.insert(C[i], current_gains[C[i]], items.weight[C[i]]); // insert in greedy order
             // checking early pruning conditions
-            auto [knapsack_value, schranke] = track(max_heap,capacity,current_gains);
+            auto [knapsack_value, schranke] = greedy.track(capacity);
             if (schranke > previous_gains->at(C[i + 1])){
-                if (s_value+knapsack_value <= s_best){ // early pruning conditions satisfied
+                if (pruned(s_value+knapsack_value, s_best)) { // early pruning conditions satisfied
                     return {true, {}, {}};
                 }
                 else { // early no-pruning conditions satisfied
+                    zbatch(S, C.data() + i + 1, C.size() - i - 1, s_value, marginal_gain.data() + i + 1);
                     for (size_t j = i+1, n =C.size(); j < n; ++j) { // compute current gains of all remianing items
-                        items[C[j]].value = z(S,C[j],s_value); 
-                        current_gains[C[j]] = items[C[j]].value / items[C[j]].weight;
-                        max_heap.push(C[j]); // insert into greedy order
-                    }
-                    while (!max_heap.empty()) {
-                        sorted_C.push_back(max_heap.top()); // store greedy order in vector sorted_C
-                        max_heap.pop();
+                        items.value[C[j]] = marginal_gain[j]; 
+                        current_gains[C[j]] = items.value[C[j]] / items.weight[C[j]];
+                        greedy.insert(C[j], current_gains[C[j]], items.weight[C[j]]); // insert into greedy order
                     }
-                    return {false, sorted_C, current_gains};
+                    greedy.sorted(sorted_C); // store greedy order in vector sorted_C
+                    return {false, std::move(sorted_C), std::move(current_gains)};
                 }
             }
     }
     
     // if neither early pruning conditions nor early pruning conditions are satified before considering the last item in C(S)
-    items[C.back()].value = z(S,C.back(),s_value); 
-    current_gains[C.back()] = items[C.back()].value / items[C.back()].weight; // compute current gain of last item in C(S)
-    max_heap.push(C.back()); // insert last item into greedy order
-    while (!max_heap.empty()) {
-        sorted_C.push_back(max_heap.top()); // store greedy order in vector sorted_C
-        max_heap.pop();
-    }
+    items.value[C.back()] = z(S,C.back(),s_value); 
+    current_gains[C.back()] = items.value[C.back()] / items.weight[C.back()]; // compute current gain of last item in C(S)
+    greedy.insert(C.back(), current_gains[C.back()], items.weight[C.back()]); // insert last item into greedy order
+    greedy.sorted(sorted_C); // store greedy order in vector sorted_C
 
-    if(s_value + SUB_EP(sorted_C, capacity, current_gains) <= s_best){ // check pruning conditions 
+    if (pruned(s_value + SUB_EP(sorted_C, capacity, current_gains), s_best)) { // check pruning conditions 
             return {true, {}, {}};
         }
        
-    return {false, sorted_C, current_gains};
+    return {false, std::move(sorted_C), std::move(current_gains)};
 }
 
 
-// auxiliary functions for EP+CR and LE+EP+CR
-// packs fractional knapsack to given capacity with current gains, returns packed value
-float Solver::packedvalue(const std::vector<int>& C, int capacity, const std::unordered_map<int, float>& current_gains) {
-    // total weight of all items in C
-    int total_weight = std::accumulate(C.begin(), C.end(), 0, [this](int sum, int c) {
-        return sum + items[c].weight;
-    });
-    
-    // pack all items in C if total weight is less/equal to capacity
-    if (total_weight <= capacity) {
-        float value = std::accumulate(C.begin(), C.end(), 0.0f, [&](float sum, int c) {
-            return sum + current_gains.at(c)*items[c].weight;
-        });
-        return value;  
-    }
-    // pack according to steepest relativ gain if not all items can be packed
-    std::vector<int> knapsackset;
-    float total_value = 0.0f;
+// auxiliary function for EP+CR and LE+EP+CR
+// packs knapsack to given capacity according to order of C, breaks if first item exceeds knapsack capacity, returns the number of packed items
+size_t Solver::packedsplit(const Candidates& C, int capacity) {
+    // pack according to steepest relativ gain, all items in C are packed if their total weight is less/equal to capacity
+    size_t split = 0;
     for (int c : C) {
-        const Item& item = items[c];
         // add item if it fits
-        if (item.weight <= capacity) {
-            capacity -= item.weight;
-            total_value += (current_gains.at(c)*item.weight);
-            knapsackset.push_back(c);
+        if (items.weight[c] <= capacity) {
+            capacity -= items.weight[c];
+            split++;
         }
-        // add fractional part if item does not fit
         else {
-            total_value += current_gains.at(c) * capacity;
             break;  // break when capacity is reached
         }
     }
-    return total_value;  
-}
-
-// packs knapsack to given capacity according to order of C, breaks if first item exceeds knapsack capacity, retunrs all packed items
-std::vector<int> Solver::packedset(const std::vector<int>& C, int capacity) {
-    // total weight of all items in C
-    int total_weight = std::accumulate(C.begin(), C.end(), 0, [this](int sum, int c) {
-        return sum + items[c].weight;
-    });
-    
-    // pack all items in C if total weight is less/equal to capacity
-    if (total_weight <= capacity) {
-        return C;  
-    }
-    // pack according to steepest relativ gain if not all items can be packed
-    std::vector<int> knapsackset;
-    for (int c : C) {
-        const Item& item = items[c];
-        // add item if it fits
-        if (item.weight <= capacity) {
-            capacity -= item.weight;
-            knapsackset.push_back(c);
-        }
-        else {
-            break;  // break when capacity is reached
-        }
-    }
-    return knapsackset;  
+    return split;
 }
 
 // Candidate Reduction for combination with EP
-std::vector<int> Solver::CRep(std::vector<int>& new_C, const float s_value, const std::vector<int>& knapsackset, const float s_best, const int capacity, const std::unordered_map<int, float>& current_gains) {
-    if (knapsackset.empty()) {
-        return new_C;  
+void Solver::CRep(Candidates& new_C, const float s_value, const size_t split, const float s_best, const int capacity, const Gains& current_gains) {
+    if (split == 0) {
+        return;
     }
 
-    std::vector<int> betrachten;
-    std::set_difference(new_C.begin(), new_C.end(), knapsackset.begin(), knapsackset.end(), std::back_inserter(betrachten));
+    KnapsackPrefix P = prefix(new_C, capacity, &current_gains);
 
-    for (int c : betrachten) {
-        Item& item = items[c];
-        if (item.weight <= capacity) {
-            auto p_value = packedvalue(new_C, capacity - item.weight,current_gains);
-            if (s_value + p_value + current_gains.at(c)*item.weight <= s_best) {
-                new_C.erase(std::remove(new_C.begin(), new_C.end(), c), new_C.end());
+    for (size_t i = split, n = new_C.size(); i < n; ++i) {
+        int c = new_C[i];
+        if (items.weight[c] <= capacity) {
+            auto p_value = prefixvalue(P, new_C, capacity - items.weight[c], &current_gains);
+            if (pruned(s_value + p_value + current_gains.at(c)*items.weight[c], s_best)) {
+                removed[c] = 1;
             }
         }
     }
-    return new_C;  
+    compact(new_C);
 } 
 
- // Early Pruning with Lazy Evaluations with average decision rule
-std::tuple<bool, std::vector<int>, std::unordered_map<int,float>> Solver::LEEP(std::vector<int> S, std::vector<int> C,float s_value, float s_best,
-    int capacity, const std::unordered_map<int,float>* previous_gains
+ // Early Pruning with Lazy Evaluations with average decision rule, or with greedy decision rule if the parent candidate set parent_C is given
+std::tuple<bool, Candidates, Gains> Solver::LEEP(const std::vector<int>& S, const Candidates& candidates, float s_value, float s_best,
+    int capacity, const Gains* previous_gains, const Candidates* parent_C
 ) {
     // delete all items from C that can not fit into the knapsack
-    C.erase(std::remove_if(C.begin(), C.end(), [this,capacity](int c) {
-        return items[c].weight > capacity;  
-    }), C.end());
+    Candidates C(&arena);
+    C.reserve(candidates.size());
+    for (int c : candidates) {
+        if (items.weight[c] <= capacity) {
+            C.push_back(c);
+        }
+    }
     // if candidate set empty return true
     if(C.empty()){
         return {true, {}, {}};
     }
 
      // initialize current gains
-    std::unordered_map<int, float> current_gains;
+    Gains current_gains(&arena);
+    current_gains.reserve(C.size());
     // if no previous gain exist, compute all relative marginal gains and check pruning conditions
     if (previous_gains == nullptr){
         // compute all relative marginal gains
         for (int c : C){
-            current_gains[c] = items[c].value / items[c].weight;
+            current_gains[c] = items.value[c] / items.weight[c];
+        }
+        // order C according to relative marginal gains up to the first item that does not fit
+        std::pmr::vector<std::pair<int, float>> ratios(&arena);
+        ratios.reserve(C.size());
+        for (int c : C) {
+            ratios.push_back({c, current_gains[c]});
+        }
+        size_t sorted = greedyorder(ratios, capacity);
+        for (size_t k = 0; k < ratios.size(); ++k) {
+            C[k] = ratios[k].first;
         }
-        // sort C according to relative marginal gains
-        std::sort(C.begin(), C.end(), [&current_gains](int a, int b) {
-            return current_gains[a] > current_gains[b];
-        });
         // check pruning conditions
-        if(s_value + SUB_EP(C, capacity, current_gains) <= s_best){
+        if (pruned(s_value + SUB_EP(C, capacity, current_gains), s_best)) {
             return {true, {}, {}};
         }
-        return {false, C, current_gains};
+        order(C, sorted, &current_gains); // the node is not pruned, order the remaining items
+        return {false, std::move(C), std::move(current_gains)};
     }
     
 
     int total_weight_updated = 0;  // initialize knapsack weight as zero
-    int i = 0; // initialize counter for current item
-    int last; // initialize tracker for first item not packed item
+    size_t i = 0; // initialize counter for current item
+    size_t last = 0; // initialize tracker for first item not packed item
     
-    bool updated = false;  // flag for breaking the update of current gains
     float R = (s_best - s_value) / capacity; // benchmark for updating current gains
 
-    // Max-Heap for ordering items according to relative marginal gain
-    auto cmp = [&](int a, int b) {
-        return (current_gains[a]) < (current_gains[b]);
-    };
-    std::priority_queue<int, std::vector<int>, decltype(cmp)> max_heap(cmp);
+    // the update of current gains stops at the first item with previous gain smaller than benchmark, only the items in front of it are updated
+    // with the parent candidate set the greedy decision rule of LEg decides instead
+    size_t fresh = 0;
+    if (parent_C) {
+        fresh = greedyrule(C, *parent_C, capacity);
+    }
+    else {
+        while (fresh < C.size() && previous_gains->at(C[fresh]) >= R) {
+            fresh++;
+        }
+    }
+
+    // the packed items only depend on the weights, the marginal gains of those to update are computed all at once
+    size_t packed = 0;
+    for (int weight = 0; packed < C.size() && weight + items.weight[C[packed]] < capacity; ++packed) {
+        weight += items.weight[C[packed]];
+    }
+    std::pmr::vector<float> marginal_gain(C.size(), &arena);
+    zbatch(S, C.data(), std::min(fresh, packed), s_value, marginal_gain.data());
+
+    // greedy order of items according to relative marginal gain
+    PackingTree greedy(&arena);
+    greedy.reserve(C.size());
 
     // pack knapsack and update current gains of packed items
-    while (i < C.size() and total_weight_updated + items[C[i]].weight < capacity){ //
-        if (!updated && previous_gains->at(C[i]) >= R) { // update current gain
-                items[C[i]].value = z(S, C[i], s_value);  
-                current_gains[C[i]] = items[C[i]].value / items[C[i]].weight;
+    while (i < C.size() and total_weight_updated + items.weight[C[i]] < capacity){ //
+        if (i < fresh) { // update current gain
+                items.value[C[i]] = marginal_gain[i];  
+                current_gains[C[i]] = items.value[C[i]] / items.weight[C[i]];
             } else {
-                current_gains[C[i]] = previous_gains->at(C[i]); // if previous gain smaller than benchmark use previous gain as current gain
-                updated = true;  // flag to stop update
+                current_gains[C[i]] = stalegain(S, C[i], *previous_gains); // if previous gain smaller than benchmark use previous gain as current gain
             }
-        max_heap.push(C[i]); // store items in greedy order
+        greedy.insert(C[i], current_gains[C[i]], items.weight[C[i]]); // store items in greedy order
 
-        total_weight_updated += items[C[i]].weight;
+        total_weight_updated += items.weight[C[i]];
         
         i = i+1;
         last = i;
     }
     // if all items were packed into the knapsack
     if(last == C.size()){
-        if(s_value + track(max_heap, capacity, current_gains).first <= s_best){ // check pruning condition
+        if (pruned(s_value + greedy.track(capacity).first, s_best)) { // check pruning condition
             return {true, {}, {}};          
         } 
-        // sort  C according to relative gain
-        std::sort(C.begin(), C.end(), [&current_gains](int a, int b) {
-            return current_gains[a] > current_gains[b];
-        });
-        return {false, C, current_gains};
+        // all items of C are in the greedy order, C is taken from it instead of sorted again
+        C.clear();
+        greedy.sorted(C);
+        return {false, std::move(C), std::move(current_gains)};
     }
 
     // consider all not packed items, except the last in C(S) (special case, considered later)
     for (size_t i = last, n =C.size()-1; i < n; ++i) {
-        if (!updated && previous_gains->at(C[i]) >= R) { // update current gain
-           items[C[i]].value = z(S, C[i], s_value);  
-            current_gains[C[i]] = items[C[i]].value / items[C[i]].weight;
+        if (i < fresh) { // update current gain
+           items.value[C[i]] = z(S, C[i], s_value);  
+            current_gains[C[i]] = items.value[C[i]] / items.weight[C[i]];
         } else {
-            current_gains[C[i]] = previous_gains->at(C[i]); // if previous gain smaller than benchmark use previous gain as current gain
-            updated = true;  // flag to stop update
+            current_gains[C[i]] = stalegain(S, C[i], *previous_gains); // if previous gain smaller than benchmark use previous gain as current gain
         }
-        max_heap.push(C[i]); // store items in greedy order
+        greedy.insert(C[i], current_gains[C[i]], items.weight[C[i]]); // store items in greedy order
 
 
         // checking early pruning conditions
-        auto [knapsack_value, schranke] = track(max_heap,capacity,current_gains);
+        auto [knapsack_value, schranke] = greedy.track(capacity);
         if(schranke > previous_gains->at(C[i + 1])){
-            if(s_value+knapsack_value <= s_best) { // early pruning conditions satisfied
+            if (pruned(s_value+knapsack_value, s_best)) { // early pruning conditions satisfied
                 return {true, {}, {}};
             }
             else{ // early no-pruning conditions satisfied
+                if (i + 1 < fresh) { // marginal gains of the remaining items to update, all at once
+                    zbatch(S, C.data() + i + 1, fresh - i - 1, s_value, marginal_gain.data() + i + 1);
+                }
                 for(size_t j = i+1, n =C.size(); j < n; ++j) { // compute current gains of all remianing items
-                    if (!updated && previous_gains->at(C[j]) >= R) { // update current gain
-                        items[C[j]].value = z(S, C[j], s_value);  
-                        current_gains[C[j]] = items[C[j]].value / items[C[j]].weight;
+                    if (j < fresh) { // update current gain
+                        items.value[C[j]] = marginal_gain[j];  
+                        current_gains[C[j]] = items.value[C[j]] / items.weight[C[j]];
                     }else {
-                        current_gains[C[j]] = previous_gains->at(C[j]); // if previous gain smaller than benchmark use previous gain as current gain
-                        updated = true;  // flag to stop update
+                        current_gains[C[j]] = stalegain(S, C[j], *previous_gains); // if previous gain smaller than benchmark use previous gain as current gain
                     }
-                    max_heap.push(C[j]); // store items in greedy order
+                    greedy.insert(C[j], current_gains[C[j]], items.weight[C[j]]); // store items in greedy order
             }
-            // sort  C according to relative gain
-                std::sort(C.begin(), C.end(), [&current_gains](int a, int b) {
-                    return current_gains[a] > current_gains[b];
-                 });
-                return {false, C, current_gains};
+            // all items of C are in the greedy order, C is taken from it instead of sorted again
+                C.clear();
+                greedy.sorted(C);
+                return {false, std::move(C), std::move(current_gains)};
             }
         }
     }
 
     // if neither early pruning conditions nor early pruning conditions are satified before considering the last item in C(S)
-    if (!updated && previous_gains->at(C.back()) >= R) { // update current gain
-        items[C.back()].value = z(S, C.back(), s_value);  
-        current_gains[C.back()] = items[C.back()].value / items[C.back()].weight;
+    if (C.size() - 1 < fresh) { // update current gain
+        items.value[C.back()] = z(S, C.back(), s_value);  
+        current_gains[C.back()] = items.value[C.back()] / items.weight[C.back()];
     } else {
-        current_gains[C.back()] = previous_gains->at(C.back()); // if previous gain smaller than benchmark use previous gain as current gain
-        updated = true;  // flag to stop update
+        current_gains[C.back()] = stalegain(S, C.back(), *previous_gains); // if previous gain smaller than benchmark use previous gain as current gain
     }
 
-    max_heap.push(C.back()); // insert last item into greedy order
+    greedy.insert(C.back(), current_gains[C.back()], items.weight[C.back()]); // insert last item into greedy order
 
-    if(s_value + track(max_heap, capacity, current_gains).first <= s_best){ // check pruning conditions 
+    if (pruned(s_value + greedy.track(capacity).first, s_best)) { // check pruning conditions 
             return {true, {}, {}};
         } 
-    // sort  C according to relative gain
-    std::sort(C.begin(), C.end(), [&current_gains](int a, int b) {
-        return current_gains[a] > current_gains[b];
-    });
-    return {false, C, current_gains};
+    // all items of C are in the greedy order, C is taken from it instead of sorted again
+    C.clear();
+    greedy.sorted(C);
+    return {false, std::move(C), std::move(current_gains)};
+}
+
+// greedy decision rule of LEg
+// input the candidates C of a node without items that can not fit, the candidate set parent_C of the parent node (C is a part of it) and the capacity left
+// output the number of items at the front of C whose gains are updated: the update stops at the first item behind position R in parent_C,
+// where R is the position at which the greedy knapsack of the items of parent_C that fit is overfilled
+size_t Solver::greedyrule(const Candidates& C, const Candidates& parent_C, int capacity) {
+    // candidate set of the parent node without items that can not fit
+    // position[c] is the position of c in CP, C is a part of CP
+    Candidates CP(&arena);
+    CP.reserve(parent_C.size());
+    if (position.size() < items.size()) {
+        position.resize(items.size());
+    }
+    for (int c : parent_C) {
+        if (items.weight[c] <= capacity) {
+            position[c] = CP.size();
+            CP.push_back(c);
+        }
+    }
+
+    float knapsackweight = 0;
+    int CPsize = CP.size();
+    int r = 0;
+    while (r < CPsize && knapsackweight <= capacity){
+        knapsackweight += items.weight[CP[r]];
+        r+=1;
+    }
+    int R = r;
+
+    size_t fresh = 0;
+    while (fresh < C.size() && position[C[fresh]] <= R) {
+        fresh++;
+    }
+    return fresh;
 }
 
 // Lazy Evaluations with greedy decision rule
-std::pair<std::vector<int>, std::unordered_map<int, float>> Solver::LEg(
+// Output: same as LE
+std::tuple<Candidates, Gains, size_t> Solver::LEg(
     const std::vector<int>& S,
-    std::vector<int> C,
-    std::vector<int> CP,
+    const Candidates& candidates,
+    const Candidates& parent_C,
     const float s_value,
     const float s_best,
     const int capacity,
-    const std::unordered_map<int, float>* previous_gains
+    const Gains* previous_gains
 ) {
-       C.erase(std::remove_if(C.begin(), C.end(), [this,capacity](int c) {
-        return items[c].weight > capacity;  
-    }), C.end());
-
+    // delete all items from C that can not fit into the knapsack
+    Candidates C(&arena);
+    C.reserve(candidates.size());
+    for (int c : candidates) {
+        if (items.weight[c] <= capacity) {
+            C.push_back(c);
+        }
+    }
     
-    std::unordered_map<int, float> current_gains; // initialize current_gains
-    std::vector<std::pair<int, float>> ratios;  // initializes relative gains
+    Gains current_gains(&arena); // initialize current_gains
+    current_gains.reserve(C.size());
+    std::pmr::vector<std::pair<int, float>> ratios(&arena);  // initializes relative gains
+    ratios.reserve(C.size());
+    size_t sorted = 0; // number of ordered items
 
     if (C.empty()){
-        return {C, current_gains};
+        return {std::move(C), std::move(current_gains), 0};
 
     }
 
-    bool updated = false;  // flag for breaking the update of current gains
-
     if (!previous_gains) { // initialize current_gains if there are no previous gains
         for (int c : C) {
-            float ratio = items[c].value / items[c].weight;
+            float ratio = items.value[c] / items.weight[c];
             current_gains[c] = ratio;
             ratios.push_back({c, ratio});
         }
+        // order according to relative gain (ratio) up to the first item that does not fit
+        sorted = greedyorder(ratios, capacity);
     } else {
-        CP.erase(std::remove_if(CP.begin(), CP.end(), [this,capacity](int c) {
-            return items[c].weight > capacity; 
-        }), CP.end());
-
-        
-        float knapsackweight = 0;
-        int CPsize = CP.size();
-        int r = 0;
-        while (r < CPsize && knapsackweight <= capacity){
-            knapsackweight += items[CP[r]].weight;
-            r+=1;
-        }
-        int R = r; 
-
-        for (int c : C) {
-            auto it = std::find(CP.begin(), CP.end(), c);
-            int position = std::distance(CP.begin(), it);
-            if (!updated && (position <= R)) { // update current gain
-                items[c].value = z(S, c, s_value);  
-                current_gains[c] = items[c].value / items[c].weight;
+        // the items in front of the first item behind the greedy knapsack of the parent node are updated all at once
+        size_t fresh = greedyrule(C, parent_C, capacity);
+        std::pmr::vector<float> marginal_gain(fresh, &arena);
+        zbatch(S, C.data(), fresh, s_value, marginal_gain.data());
+
+        for (size_t k = 0; k < C.size(); ++k) {
+            int c = C[k];
+            if (k < fresh) { // update current gain
+                items.value[c] = marginal_gain[k];
+                current_gains[c] = items.value[c] / items.weight[c];
             } else {
-                current_gains[c] = previous_gains->at(c); // if previous gain smaller than benchmark use previous gain as current gain
-                updated = true;  // flag to stop update
+                current_gains[c] = stalegain(S, c, *previous_gains); // if previous gain smaller than benchmark use previous gain as current gain
             }
             ratios.push_back({c, current_gains[c]});  
         }
+        // C is ordered according to the previous gains, only the updated items are sorted and merged with the others
+        sorted = lazyorder(ratios, fresh);
     }
-    // Sort according to relative gain (ratio)
-    std::sort(ratios.begin(), ratios.end(), [](const std::pair<int, float>& a, const std::pair<int, float>& b) {
-        return a.second > b.second;  
-    });
-    // extract sorted items
-    std::vector<int> sorted_filtered_C;
+    // extract items
+    Candidates sorted_filtered_C(&arena);
+    sorted_filtered_C.reserve(ratios.size());
     for (const auto& ratio : ratios) {
         sorted_filtered_C.push_back(ratio.first);
     }
-    return {sorted_filtered_C, current_gains};
+    return {std::move(sorted_filtered_C), std::move(current_gains), sorted};
 }
\ No newline at end of file
@@ -10,6 +10,19 @@ by Sabine Münch and Stephen Raach
 
 #include <vector>
 #include <set>
+#include <new>
+#include <memory_resource>
+#include <unordered_map>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <cmath>
+#include "Arena.h"
+#include "GainTable.h"
+#include "GainCache.h"
+#include "Incumbent.h"
+#include "SharedSearch.h"
+#include "Trace.h"
 #include <nlohmann/json.hpp>
 
 using json = nlohmann::json;
@@ -23,86 +36,236 @@ extern std::chrono::high_resolution_clock::time_point end_time_limit;
 extern std::vector<float> values;
 extern std::vector<int> weights;
 
+// allocator for cache line aligned item arrays
+template<typename T, size_t Alignment = 64>
+struct AlignedAllocator {
+    using value_type = T;
+    template<typename U> struct rebind { using other = AlignedAllocator<U, Alignment>; };
+
+    AlignedAllocator() = default;
+    template<typename U> AlignedAllocator(const AlignedAllocator<U, Alignment>&) {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+    }
+    void deallocate(T* p, size_t) {
+        ::operator delete(p, std::align_val_t(Alignment));
+    }
+    template<typename U> bool operator==(const AlignedAllocator<U, Alignment>&) const { return true; }
+    template<typename U> bool operator!=(const AlignedAllocator<U, Alignment>&) const { return false; }
+};
+
+// candidate sets and current gains of a search node, allocated from the arena of the solver
+using Candidates = std::pmr::vector<int>;
+using Gains = std::pmr::unordered_map<int, float>;
+
 class Solver {
     public:    
-    struct Item {
-        std::string name;
-        int weight;
-        float value;
-    
-        Item(std::string n, int w, float v) : name(std::move(n)), weight(w), value(v) {}
+    // items stored as separate arrays, item i has weight[i], value[i] and inv_weight[i] = 1/weight[i]
+    // the name of an item is its index, it is only built for output
+    struct Items {
+        std::vector<int, AlignedAllocator<int>> weight;
+        std::vector<float, AlignedAllocator<float>> value;
+        std::vector<float, AlignedAllocator<float>> inv_weight;
+
+        void push_back(int w, float v) {
+            weight.push_back(w);
+            value.push_back(v);
+            inv_weight.push_back(1.0f / w);
+        }
+        size_t size() const { return weight.size(); }
+        std::string name(int i) const { return std::to_string(i); }
     };
-    
-        std::vector<Item> items; 
+
+    // prefix sums of a candidate set ordered according to relative gain
+    // weight[k] and value[k] are weight and value of the first k items, ratio[k] is the relative gain of item k
+    // only the items packed by the greedy knapsack are stored, split is the position of the first item that does not fit
+    struct KnapsackPrefix {
+        std::pmr::vector<int> weight;
+        std::pmr::vector<float> value;
+        std::pmr::vector<float> ratio;
+        size_t split = 0;
+
+        explicit KnapsackPrefix(std::pmr::memory_resource* resource) : weight(resource), value(resource), ratio(resource) {}
+    };
+
+    // 0/1 knapsack table of a candidate set with the modular gains of its items
+    // at(k, j) is the best value of the items k, ..., rows-2 with capacity j, the last row is empty
+    // weight[k] and value[k] are weight and gain of item k, the table has no rows if it was not built
+    struct KnapsackDP {
+        std::pmr::vector<float> table;
+        std::pmr::vector<int> weight;
+        std::pmr::vector<float> value;
+        int capacity = 0;
+        size_t rows = 0;
+
+        explicit KnapsackDP(std::pmr::memory_resource* resource) : table(resource), weight(resource), value(resource) {}
+
+        float at(size_t k, int j) const { return table[k * (capacity + 1) + j]; }
+
+        // bound of the subtree below S+item k: its gain and the best value of the items behind it in the capacity left
+        float child(size_t k) const { return value[k] + at(k + 1, capacity - weight[k]); }
+    };
+
+        Items items; 
         int counter = 0;
 
+        // evaluations of f and of the marginal gain hooks, counted by the hooks set in main
+        long oracle_calls = 0;
+
+        // recorder of the search tree, nullptr if no trace is recorded
+        Trace* trace = nullptr;
+
+        // positions of the items in the parent candidate set of LEg, indexed by item
+        std::vector<int> position;
+
+        // largest table (|C|+1)*(capacity+1) of the DP bound, 0 disables the DP bound
+        size_t dp_cells = 0;
+
+        // items marked for deletion by candidate reduction, indexed by item
+        std::vector<char> removed;
+
+        // buffers of the search nodes, released on backtrack
+        Arena arena;
+
+        // best solution of all solvers working on the instance
+        std::shared_ptr<Incumbent> incumbent = std::make_shared<Incumbent>();
+
+        // best solution of all worker processes, nullptr if the solver does not run in a worker process
+        SharedSearch* shared = nullptr;
+
+        // set by the first solver of a portfolio that finishes, nullptr if the solver runs alone
+        std::atomic<bool>* stop = nullptr;
+
+        // true if the time limit is exceeded or the search was stopped
+        bool stopped() const {
+            return std::chrono::high_resolution_clock::now() > end_time_limit || (stop && stop->load(std::memory_order_relaxed));
+        }
+
+        // relative tolerance of the pruning tests, bounds less than tolerance*|s_best| above s_best are rounded down by the float sums
+        float tolerance = 0.0f;
+
+        // relative slack of a value from the gain cache: f(S-v) + z(S-v, v) and f(S) are float sums over the same m terms in a different order,
+        // they differ by at most m * 2^-24 relative to f(S), which stays below 1e-3 for up to 16000 elements, customers or targets
+        static constexpr float cache_slack = 1e-3f;
+
+        // pruning test of all bounds, a node or an item with upper bound bound can not improve s_best
+        bool pruned(float bound, float s_best) const {
+            return bound <= s_best - tolerance * std::fabs(s_best);
+        }
+
+        // publishes S if it improves the incumbent, returns the best of s_value, s_best and the incumbent (of all processes)
+        float improve(const std::vector<int>& S, float s_value, float s_best);
+
+        // singleton and pair values computed at startup
+        GainTable gaintable;
+
+        // gains evaluated on the search path and the values of the sets on the path, disabled if it has no entries
+        GainCache cache;
+
+        // buffer for S+c in z
+        std::vector<int> updated_S;
+
         // objective function f 
         std::function<float(const std::vector<int>&)> f;
 
+        // marginal gain f(S+c)-f(S) from an incremental state of the objective, used by z instead of f if it is set
+        std::function<float(const std::vector<int>&, int)> gain;
+
+        // marginal gains of several items at once from the incremental state of the objective, used by zbatch if it is set
+        std::function<void(const std::vector<int>&, const int*, size_t, float*)> gains;
+
         // marginal gain function z
         float z(const std::vector<int>& S, const int c, float s_value);
 
-        // dynamic candidate ordering
-        std::vector<int> DCO(const std::vector<int>& S, std::vector<int> C, const float s_value, const int capacity) ;
+        // objective value f(S) of a search node, from the gain cache if possible
+        float value(const std::vector<int>& S, float s_best);
+
+        // marginal gains of the n items C[0], ..., C[n-1], out[k] = z(S, C[k], s_value)
+        void zbatch(const std::vector<int>& S, const int* C, size_t n, float s_value, float* out);
+
+        // current gain of an item that is not reevaluated: previous gain, tightened by the pair bound of the gain table
+        float stalegain(const std::vector<int>& S, int c, const Gains& previous_gains);
+
+        // dynamic candidate ordering, returns the candidates and the number of ordered items
+        std::pair<Candidates, size_t> DCO(const std::vector<int>& S, const Candidates& C, const float s_value, const int capacity) ;
+
+        // orders items and relative gains up to the first item that does not fit, returns the number of ordered items
+        size_t greedyorder(std::pmr::vector<std::pair<int, float>>& ratios, int capacity);
+
+        // orders items and relative gains of Lazy Evaluations, only the first fresh items are sorted, returns the number of ordered items
+        size_t lazyorder(std::pmr::vector<std::pair<int, float>>& ratios, size_t fresh);
+
+        // orders the items of C behind the first sorted items, used if a node is not pruned
+        void order(Candidates& C, size_t sorted, const Gains* current_gains = nullptr);
 
         // SUB heuristic for pruning nodes
-        float SUB(std::vector<int>& C, int capacity);
+        float SUB(const Candidates& C, int capacity);
 
         // SUB_CR heuristic for pruning nodes
-        std::pair<float, std::vector<int>> SUB_CR(const std::vector<int>& C, int capacity);
+        std::pair<float, size_t> SUB_CR(const Candidates& C, int capacity);
 
         // SUB_LE heuristic for pruning nodes
-        float SUB_LE(std::vector<int>& C, int capacity, const std::unordered_map<int, float>& current_gains);
+        float SUB_LE(const Candidates& C, int capacity, const Gains& current_gains);
 
         // SUB_EP heuristic for pruning nodes
-        float SUB_EP(std::vector<int>& C, int capacity, const std::unordered_map<int, float>& current_gains);
+        float SUB_EP(const Candidates& C, int capacity, const Gains& current_gains);
 
         // SUB_LECR heuristic for pruning nodes
-        std::pair<float, std::vector<int>> SUB_LECR(const std::vector<int>& C, int capacity, const std::unordered_map<int, float>& current_gains);
+        std::pair<float, size_t> SUB_LECR(const Candidates& C, int capacity, const Gains& current_gains);
+
+        // DP bound, 0/1 knapsack table of the candidates if it has at most dp_cells entries
+        KnapsackDP knapsack(const Candidates& C, int capacity, const Gains* current_gains = nullptr);
+
+        // prefix sums for candidate reduction, built once per node
+        KnapsackPrefix prefix(const Candidates& C, int capacity, const Gains* current_gains = nullptr);
+
+        // fractional knapsack value of C for a reduced capacity using the prefix sums of C
+        float prefixvalue(const KnapsackPrefix& P, const Candidates& C, int capacity, const Gains* current_gains = nullptr);
+
+        // deletes all marked items from C
+        void compact(Candidates& C);
 
         // CR Candidate Reduction
-        std::vector<int> CR(std::vector<int>& new_C, const float s_value, const std::vector<int>& knapsackset, const float s_best, const int capacity);
+        void CR(Candidates& new_C, const float s_value, const size_t split, const float s_best, const int capacity);
 
         // CR_LE Candidate Reduction with Lazy Evaluations with average decision rule
-        std::vector<int> CR_LE(std::vector<int>& new_C, const float s_value, const std::vector<int>& knapsackset, const float s_best, const int capacity, const std::unordered_map<int, float>& current_gains);
+        void CR_LE(Candidates& new_C, const float s_value, const size_t split, const float s_best, const int capacity, const Gains& current_gains);
 
         // Lazy Evaluations with average decision rule
-        std::pair<std::vector<int>, std::unordered_map<int, float>> LE(
+        std::tuple<Candidates, Gains, size_t> LE(
             const std::vector<int>& S,
-            const std::vector<int>& C,
+            const Candidates& C,
             const float s_value,
             const float s_best,
             const int capacity,
-            const std::unordered_map<int, float>* previous_gains = nullptr);
-
-        // Early Pruning with Lazy Evaluation with average decision rule
-        std::tuple<bool, std::vector<int>, std::unordered_map<int,float>> LEEP(std::vector<int> S, std::vector<int> C,float s_value, float s_best, int capacity,const std::unordered_map<int,float>* previous_gains = nullptr);
+            const Gains* previous_gains = nullptr);
 
-        // track function for EP
-        template<typename HeapType>
-        std::pair<float,float> track(HeapType max_heap, int capacity, const std::unordered_map<int, float>& current_gains);
+        // Early Pruning with Lazy Evaluation with average decision rule, with greedy decision rule if the parent candidate set is given
+        std::tuple<bool, Candidates, Gains> LEEP(const std::vector<int>& S, const Candidates& C, float s_value, float s_best, int capacity,const Gains* previous_gains = nullptr, const Candidates* parent_C = nullptr);
 
         // Early Pruning EP
-        std::tuple<bool, std::vector<int>, std::unordered_map<int, float>> EP(std::vector<int> S, std::vector<int> C,float s_value, float s_best,
-        int capacity, const std::unordered_map<int, float>* previous_gains = nullptr);
-
-        // auxiliary functions for EP+CR
-        std::vector<int> packedset(const std::vector<int>& C, int capacity);
+        std::tuple<bool, Candidates, Gains> EP(const std::vector<int>& S, const Candidates& C, float s_value, float s_best,
+        int capacity, const Gains* previous_gains = nullptr);
 
-        float packedvalue(const std::vector<int>& C, int capacity, const std::unordered_map<int, float>& current_gains);
+        // auxiliary function for EP+CR, number of items packed into the knapsack
+        size_t packedsplit(const Candidates& C, int capacity);
 
         // CR for combination with EP
-        std::vector<int> CRep(std::vector<int>& new_C, const float s_value, const std::vector<int>& knapsackset, const float s_best, const int capacity, const std::unordered_map<int, float>& current_gains); 
+        void CRep(Candidates& new_C, const float s_value, const size_t split, const float s_best, const int capacity, const Gains& current_gains); 
+
+        // greedy decision rule of LEg, number of items at the front of C whose gains are updated
+        size_t greedyrule(const Candidates& C, const Candidates& parent_C, int capacity);
 
         // Lazy Evaluations with greedy decision rule
-        std::pair<std::vector<int>, std::unordered_map<int, float>> LEg(
+        std::tuple<Candidates, Gains, size_t> LEg(
         const std::vector<int>& S,
-        std::vector<int> C,
-        std::vector<int> CP,
+        const Candidates& C,
+        const Candidates& parent_C,
         const float s_value,
         const float s_best,
         const int capacity,
-        const std::unordered_map<int, float>* previous_gains = nullptr
+        const Gains* previous_gains = nullptr
         );
 
         // default settings for solver
@@ -110,7 +273,23 @@ class Solver {
 
         virtual ~Solver() = default;
 
-        virtual float solve(const std::vector<int>& C, int B) = 0;
+        // searches the subtree of S, the items of C may be added to S
+        virtual float solve(std::vector<int>& S, const std::vector<int>& C, int B) = 0;
+
+        // searches the whole search tree
+        float solve(const std::vector<int>& C, int B) {
+            std::vector<int> S;
+            return solve(S, C, B);
+        }
+
+        // weight of a set
+        int weight(const std::vector<int>& S) const {
+            int total = 0;
+            for (int v : S) {
+                total += items.weight[v];
+            }
+            return total;
+        }
     };
 
     
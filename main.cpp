@@ -8,86 +8,233 @@ by Sabine Münch and Stephen Raach
 #include <iostream>
 #include <memory>
 #include <chrono>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <functional>
+#include <algorithm>
 #include "functions.h"
 #include "objectivefunctions.h"
 #include "Load.h"
-#include "DCOSUBSolver.h"
-#include "ACRSolver.h"
-#include "LESolver.h"
-#include "LECRSolver.h"
-#include "EPSolver.h"
-#include "EPCRSolver.h"
-#include "LEEPSolver.h"
-#include "LEEPCRSolver.h"
-#include "LEgSolver.h"
+#include "COVEngine.h"
+#include "INFEngine.h"
+#include "LOCEngine.h"
+#include "Numa.h"
+#include "PolicySolver.h"
 
 
 
-int main(int argc, char* argv[]) {
-    if (argc != 4) {
-        std::cerr << "Usage: " << argv[0] << "<knapsack capacity> <objective_function_type> <solver_type>" << std::endl;
-        return 1;
-    }
-
-    int B = std::stoi(argv[1]);  // input knapsack capacity B
-    int objective_type = std::stoi(argv[2]);  // input objective function
-    int solver_type = std::stoi(argv[3]);  // input solver
-
-    std::unique_ptr<Solver> solver;
-
-    // Choose solver
+// solver of type y, nullptr if the type is unknown
+std::unique_ptr<Solver> makeSolver(int solver_type) {
     if (solver_type == 0)
     {
-        solver = std::make_unique<DCOSUBSolver>(); // Algorithm 1 
+        return std::make_unique<DCOSUBSolver>(); // Algorithm 1 
     }
     else if (solver_type == 1)
     {
-        solver = std::make_unique<ACRSolver>(); // Candidate Reduction
+        return std::make_unique<ACRSolver>(); // Candidate Reduction
     }
     else if (solver_type == 2)
     {
-        solver = std::make_unique<LESolver>(); // Lazy Evaluations with average decision rule
+        return std::make_unique<LESolver>(); // Lazy Evaluations with average decision rule
     } 
     else if (solver_type == 3)
     {
-        solver = std::make_unique<EPSolver>(); // Early Pruning
+        return std::make_unique<EPSolver>(); // Early Pruning
     }
     else if (solver_type == 4)
     {
-        solver = std::make_unique<LECRSolver>(); // Lazy Evaluations with average decision rule and Candidate Reduction
+        return std::make_unique<LECRSolver>(); // Lazy Evaluations with average decision rule and Candidate Reduction
     }
     else if (solver_type == 5)
     {
-        solver = std::make_unique<EPCRSolver>(); // Lazy Evaluations with average decision rule and Candidate Reduction
+        return std::make_unique<EPCRSolver>(); // Early Pruning and Candidate Reduction
     }
     else if (solver_type == 6)
     {
-        solver = std::make_unique<LEEPSolver>(); // Lazy Evaluations with average decision rule and Candidate Reduction
+        return std::make_unique<LEEPSolver>(); // Lazy Evaluations with average decision rule and Early Pruning
     }
     else if (solver_type == 7)
     {
-        solver = std::make_unique<LEEPCRSolver>(); // Lazy Evaluations with average decision rule, Early Pruning, and Candidate Reduction
+        return std::make_unique<LEEPCRSolver>(); // Lazy Evaluations with average decision rule, Early Pruning, and Candidate Reduction
     }
     else if (solver_type == 8)
     {
-        solver = std::make_unique<LEgSolver>(); // Lazy Evaluations with greedy decision rule
+        return std::make_unique<LEgSolver>(); // Lazy Evaluations with greedy decision rule
     }
-    else {
-        std::cerr << "unknown solver type: " << solver_type << std::endl;
+    else if (solver_type == 9)
+    {
+        return std::make_unique<LEgCRSolver>(); // Lazy Evaluations with greedy decision rule and Candidate Reduction
+    }
+    else if (solver_type == 10)
+    {
+        return std::make_unique<LEgEPSolver>(); // Lazy Evaluations with greedy decision rule and Early Pruning
+    }
+    else if (solver_type == 11)
+    {
+        return std::make_unique<LEgEPCRSolver>(); // Lazy Evaluations with greedy decision rule, Early Pruning, and Candidate Reduction
+    }
+    return nullptr;
+}
+
+
+// splits a comma separated list
+std::vector<std::string> split(const std::string& list) {
+    std::vector<std::string> parts;
+    size_t first = 0;
+    while (first <= list.size()) {
+        size_t comma = std::min(list.find(',', first), list.size());
+        parts.push_back(list.substr(first, comma - first));
+        first = comma + 1;
+    }
+    return parts;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 4) {
+        std::cerr << "Usage: " << argv[0] << "<knapsack capacity> <objective_function_type> <solver_type> [--pairs k] [--threads t] [--loc-storage float|uint16] [--gain-threads t] [--numa default|interleave|replicate] [--affinity cpus] [--trace file] [--gain-cache entries] [--dp-bound cells] [--tolerance eps] [--workers k]" << std::endl;
         return 1;
     }
-    
+
+    int B = std::stoi(argv[1]);  // input knapsack capacity B
+    int objective_type = std::stoi(argv[2]);  // input objective function
+
+    // options
+    size_t pairs = 0; // number of items whose pair values are stored in the gain table
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency()); // threads for building the gain table
+    unsigned gain_threads = 1; // threads for the marginal gains of wide nodes
+    LOCEngine::Storage loc_storage = LOCEngine::Storage::Float; // storage of the benefit rows for LOC gains
+    std::string trace_path; // binary trace of the search tree, empty if no trace is recorded
+    size_t cache_entries = 0; // entries of the gain cache, 0 disables the cache
+    size_t dp_cells = 0; // largest knapsack table of the DP bound, 0 disables the DP bound
+    float tolerance = 0.0f; // relative tolerance of the pruning tests
+    unsigned workers = 0; // worker processes that search the subtrees of the root, 0 searches in this process
+    for (int a = 4; a < argc; ++a) {
+        std::string option = argv[a];
+        if (option == "--pairs" && a + 1 < argc) {
+            pairs = std::stoul(argv[++a]);
+        }
+        else if (option == "--threads" && a + 1 < argc) {
+            threads = std::stoul(argv[++a]);
+        }
+        else if (option == "--gain-threads" && a + 1 < argc) {
+            gain_threads = std::stoul(argv[++a]);
+        }
+        else if (option == "--numa" && a + 1 < argc) {
+            std::string placement = argv[++a];
+            if (placement == "default") {
+                Numa::placement = Numa::Placement::Default;
+            }
+            else if (placement == "interleave") {
+                Numa::placement = Numa::Placement::Interleave;
+            }
+            else if (placement == "replicate") {
+                Numa::placement = Numa::Placement::Replicate;
+            }
+            else {
+                std::cerr << "unknown placement: " << placement << std::endl;
+                return 1;
+            }
+        }
+        else if (option == "--workers" && a + 1 < argc) {
+            workers = std::stoul(argv[++a]);
+        }
+        else if (option == "--tolerance" && a + 1 < argc) {
+            tolerance = std::stof(argv[++a]);
+        }
+        else if (option == "--dp-bound" && a + 1 < argc) {
+            dp_cells = std::stoul(argv[++a]);
+        }
+        else if (option == "--gain-cache" && a + 1 < argc) {
+            cache_entries = std::stoul(argv[++a]);
+        }
+        else if (option == "--trace" && a + 1 < argc) {
+            trace_path = argv[++a];
+        }
+        else if (option == "--affinity" && a + 1 < argc) {
+            Numa::cpus = Numa::parse_cpus(argv[++a]);
+        }
+        else if (option == "--loc-storage" && a + 1 < argc) {
+            std::string storage = argv[++a];
+            if (storage == "float") {
+                loc_storage = LOCEngine::Storage::Float;
+            }
+            else if (storage == "uint16") {
+                loc_storage = LOCEngine::Storage::UInt16;
+            }
+            else {
+                std::cerr << "unknown storage: " << storage << std::endl;
+                return 1;
+            }
+        }
+        else {
+            std::cerr << "unknown option: " << option << std::endl;
+            return 1;
+        }
+    }
+
+    if (cache_entries > 0 && loc_storage == LOCEngine::Storage::UInt16) { // quantized gains are upper bounds, they do not give f(S+c)
+        std::cerr << "the gain cache needs exact gains, it can not be combined with --loc-storage uint16" << std::endl;
+        return 1;
+    }
+
+    // Choose solvers, a list of several solver types runs them as a portfolio on separate threads
+    std::vector<int> solver_types;
+    std::vector<std::unique_ptr<Solver>> solvers;
+    for (const std::string& type : split(argv[3])) {
+        solver_types.push_back(std::stoi(type));
+        solvers.push_back(makeSolver(solver_types.back()));
+        if (!solvers.back()) {
+            std::cerr << "unknown solver type: " << solver_types.back() << std::endl;
+            return 1;
+        }
+    }
+
+    if (workers > 0 && (solvers.size() > 1 || !trace_path.empty())) {
+        std::cerr << "worker processes run a single solver type without trace" << std::endl;
+        return 1;
+    }
+
+    // the solvers share the incumbent, the first solver that finishes stops the others
+    auto incumbent = std::make_shared<Incumbent>();
+    std::atomic<bool> stop{false};
+    for (auto& solver : solvers) {
+        solver->incumbent = incumbent;
+        if (solvers.size() > 1) {
+            solver->stop = &stop;
+        }
+    }
+
+    // one trace per solver, the solvers of a portfolio write to file.y
+    std::vector<std::unique_ptr<Trace>> traces;
+    if (!trace_path.empty()) {
+        for (size_t k = 0; k < solvers.size(); ++k) {
+            std::string path = solvers.size() > 1 ? trace_path + "." + std::to_string(solver_types[k]) : trace_path;
+            traces.push_back(std::make_unique<Trace>());
+            if (!traces.back()->open(path, solver_types[k], objective_type, B)) {
+                std::cerr << "cannot write trace: " << path << std::endl;
+                return 1;
+            }
+            solvers[k]->trace = traces.back().get();
+        }
+    }
+
     // Choose objective function and data
+    std::function<float(const std::vector<int>&)> f;
+    std::function<float(int)> single; // f({i}) for the gain table
     if (objective_type == 0) { // COV
-        solver->f = f1;
+        f = f1;
+        single = f1_single;
         loadData = loadData_f1;
     } 
     else if (objective_type == 1) { // LOC
-        solver->f = f2;
+        f = f2;
+        single = f2_single;
         loadData = loadData_f2;
     } 
     else if (objective_type == 2) { // INF
-        solver->f = f3;
+        f = f3;
+        single = f3_single;
         loadData = loadData_f3;
     }
     else {
@@ -95,29 +242,148 @@ int main(int argc, char* argv[]) {
         return 1;
     }
     
-    loadData();
+    // the solver runs on the first CPU of the affinity list, the instance is loaded (first touch) by the pinned thread
+    bool pinned = !Numa::cpus.empty() && Numa::pin({Numa::cpus[0]});
+
+    // marginal gains from an incremental state of the objective, each solver has its own state
+    std::vector<std::shared_ptr<ObjectiveEngine>> engines;
+    // singletons (and pairs) are evaluated once, the table is copied to all solvers and gives the gains of the root
+    GainTable gaintable;
+    {
+        InterleaveScope interleave; // instance storage is interleaved over all nodes for placement Interleave
+        loadData();
+        // the table is built while the engines are constructed, both only read the instance
+        std::thread table([&]() {
+            InterleaveScope interleave; // the policy is set per thread, the table is allocated and filled by this thread
+            gaintable.build(f, single, weights, pairs, threads);
+        });
+        for (size_t k = 0; k < solvers.size(); ++k) {
+            if (objective_type == 0) { // COV gains from the number of items covering each element
+                engines.push_back(std::make_shared<COVEngine>());
+            }
+            else if (objective_type == 1) { // LOC gains from the best benefit of each customer
+                engines.push_back(std::make_shared<LOCEngine>(loc_storage));
+            }
+            else { // INF gains from the survival probabilities of the targets
+                engines.push_back(std::make_shared<INFEngine>());
+            }
+        }
+        table.join();
+    }
+
     std::vector<int> C;
-    for (size_t i = 0, n = weights.size(); i < n; ++i) {       
+    for (size_t i = 0, n = weights.size(); i < n; ++i) {
+        // add item to initial candidate set
+        C.push_back(i);
+    }
+    for (size_t k = 0; k < solvers.size(); ++k) {
+        Solver& solver = *solvers[k];
+        auto engine = engines[k];
+        // the gain threads of solver k are pinned behind the solver threads (or worker processes) and the gain threads of the solvers before k
+        unsigned slots = std::max<unsigned>(solvers.size(), workers);
+        engine->setthreads(gain_threads, slots + k * (gain_threads - 1));
+        long& calls = solver.oracle_calls;
+        solver.f = [&calls, f](const std::vector<int>& S) { calls++; return f(S); };
+        solver.gain = [&calls, engine](const std::vector<int>& S, int c) { calls++; return engine->gain(S, c); };
+        solver.gains = [&calls, engine](const std::vector<int>& S, const int* C, size_t n, float* out) { calls += n; engine->gains(S, C, n, out); };
+        solver.gaintable = gaintable;
+        solver.cache.resize(cache_entries, weights.size());
+        solver.dp_cells = dp_cells;
+        solver.tolerance = tolerance;
+        for (size_t i = 0, n = weights.size(); i < n; ++i) {
             // construct item
-            solver->items.push_back(Solver::Item{std::to_string(i), weights[i], solver->f({static_cast<int>(i)})});
-            // add item to initial candidate set
-            C.push_back(i);
+            solver.items.push_back(weights[i], gaintable.single(i));
         }
-
+    }
 
     // time measurement and time limit
     auto time_limit = std::chrono::seconds(3600); //time limit one hour
     startzeit = std::chrono::high_resolution_clock::now();
     end_time_limit = startzeit + time_limit;
 
-    float best_solution = solver->solve(C, B); // call solver
+    float best_solution;
+    size_t winner = 0; // solver that finished first
+    SharedSearch shared;
+    if (workers > 0) { // the subtrees of the root are searched by worker processes
+        // root candidates ordered according to relative gain, task k is the subtree of {order[k]}
+        std::vector<int> order;
+        for (int c : C) {
+            if (weights[c] <= B) {
+                order.push_back(c);
+            }
+        }
+        std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+            return gaintable.single(a) / weights[a] > gaintable.single(b) / weights[b];
+        });
+        if (!shared.create(order.size(), weights.size())) {
+            std::cerr << "cannot create shared memory segment" << std::endl;
+            return 1;
+        }
+        best_solution = shared.run(*solvers[0], order, B, workers);
+        solvers[0]->counter = shared.nodes();
+        solvers[0]->oracle_calls = shared.oracle_calls();
+    }
+    else if (solvers.size() == 1) {
+        best_solution = solvers[0]->solve(C, B); // call solver
+    }
+    else { // portfolio: every solver runs on its own thread
+        std::vector<std::thread> workers;
+        for (size_t k = 0; k < solvers.size(); ++k) {
+            workers.emplace_back([&, k]() {
+                Numa::pin_worker(k);
+                float value = solvers[k]->solve(C, B);
+                if (!stop.exchange(true)) { // the search of solver k is complete, stop the others
+                    winner = k;
+                    best_solution = value;
+                }
+            });
+        }
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+    }
+    Solver* solver = solvers[winner].get();
+
+    // write the remaining records of the traces
+    for (auto& solver : solvers) {
+        solver->trace = nullptr;
+    }
+    traces.clear();
 
     auto endzeit = std::chrono::high_resolution_clock::now();
     std::chrono::duration<double> runtime = endzeit - startzeit;
 
     
     // print result
-    std::cout << "optimal solution value: " << best_solution << " " << "running time: " << runtime.count() << " " << "considered nodes: " << solver->counter << std::endl;
+    // a task abandoned by the worker processes was not searched, the value is only the best one found
+    bool proven = workers == 0 || shared.proven();
+    std::cout << (proven ? "optimal solution value: " : "best solution value (not proven optimal): ") << best_solution << " " << "running time: " << runtime.count() << " " << "considered nodes: " << solver->counter << std::endl;
+
+    // print placement of the instance and the threads, always the second line
+    std::cout << "numa nodes: " << Numa::nodes() << " " << "placement: " << Numa::name(Numa::placement) << " " << "affinity: " << (pinned ? Numa::format_cpus(Numa::cpus) : "none") << std::endl;
+
+    // print the solver of a portfolio that finished first and the nodes of all solvers
+    if (solvers.size() > 1) {
+        long total = 0;
+        for (auto& s : solvers) {
+            total += s->counter;
+        }
+        std::cout << "portfolio winner: " << solver_types[winner] << " " << "improvements of incumbent: " << incumbent->version() << " " << "considered nodes of all solvers: " << total << std::endl;
+    }
+
+    // print the worker processes, the workers that died and their tasks that were searched again
+    if (workers > 0) {
+        std::cout << "worker processes: " << workers << " " << "crashed workers: " << shared.crashes << " " << "requeued tasks: " << shared.requeued() << " " << "abandoned tasks: " << shared.abandoned() << std::endl;
+    }
+
+    // print memory used by the search nodes, the arenas of worker processes are not reported
+    double nodes = std::max(solver->counter, 1);
+    if (workers == 0) {
+        std::cout << "arena bytes per node: " << solver->arena.bytes / nodes << " " << "arena allocations per node: " << solver->arena.allocations / nodes << " " << "arena peak bytes: " << solver->arena.peak << std::endl;
+    }
+
+    // print evaluations of the objective, the gain table built at startup is not counted
+    std::cout << "oracle calls: " << solver->oracle_calls << " " << "oracle calls per node: " << solver->oracle_calls / nodes << " " << "values from gain cache: " << solver->cache.hits << std::endl;
 
-    return 0;
+    return proven ? 0 : 2;
 }
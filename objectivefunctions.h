@@ -16,21 +16,23 @@ by Sabine Münch and Stephen Raach
 #include <nlohmann/json.hpp>
 #include <iomanip> 
 #include "Load.h"
+#include "Numeric.h"
 
 // objective function is COV
 float f1(const std::vector<int>& X) {
     std::vector<bool> covered_areas(values.size(), false); 
-    float total_value = 0.0f;
+    Accumulator total_value;
 
     for (int v : X) {
-        for (int district : districts[v]) {
+        for (int k = first_element[v]; k < first_element[v + 1]; ++k) { // elements covered by v
+            int district = elements[k];
             if (!covered_areas[district]) {
                 covered_areas[district] = true;
-                total_value += values[district];
+                total_value.add(values[district]);
             }
         }
     }
-    return total_value; 
+    return total_value.value(); 
 }
 
 // objective function is LOC
@@ -45,7 +47,11 @@ float f2(const std::vector<int>& X) {
             max_values[j] = std::max(max_values[j], benefits[x][j]);
         }
     }
-    return std::accumulate(max_values.begin(), max_values.end(), 0.0f); 
+    Accumulator total_value;
+    for (float value : max_values) {
+        total_value.add(value);
+    }
+    return total_value.value(); 
 }
 
 // objective function is INF
@@ -53,20 +59,48 @@ float f3(const std::vector<int>& X) {
     if (X.empty()) return 0.0;
     std::vector<float> pro(m, 1.0);
     for (int v : X) {
-        for (int j = 0; j < m; j++) {
-            if (connections[v][j] == 1) {
-                pro[j] *= (1 - p[v]);
-            }
+        for (int k = first_target[v]; k < first_target[v + 1]; k++) { // targets connected to v
+            pro[targets[k]] *= (1 - p[v]);
         }
     }
-    float sum = 0.0;
+    Accumulator sum;
     for (float val : pro) {
         if (val < 1) {
-            sum += (1 - val);
+            sum.add(1 - val);
         }
-        else{
-            sum += 0;
+    }
+    return sum.value();
+}
+
+// f({v}) of a single item, the same terms are added in the same order as in f1, f2 and f3, so the values are identical
+// no state of the size of the ground set is allocated, the gain table evaluates all items with these at startup
+
+// COV: the elements of v are distinct
+float f1_single(int v) {
+    Accumulator total_value;
+    for (int k = first_element[v]; k < first_element[v + 1]; ++k) {
+        total_value.add(values[elements[k]]);
+    }
+    return total_value.value();
+}
+
+// LOC: the best benefit of every customer is the benefit of v
+float f2_single(int v) {
+    Accumulator total_value;
+    for (float value : benefits[v]) {
+        total_value.add(value);
+    }
+    return total_value.value();
+}
+
+// INF: the targets of v are distinct, the other targets keep probability 1
+float f3_single(int v) {
+    float val = 1 - p[v];
+    Accumulator sum;
+    if (val < 1) {
+        for (int k = first_target[v]; k < first_target[v + 1]; k++) {
+            sum.add(1 - val);
         }
     }
-    return sum;
+    return sum.value();
 }